@@ -0,0 +1,354 @@
+#pragma once
+
+#include "hull3d.h"
+#include "parallel.h"
+
+#include <limits>
+
+/*
+ * A subset of a point set whose convex hull approximates the hull of the whole set.
+ */
+template<class Point>
+struct epsilon_kernel {
+	std::vector<Point> points;
+
+	// Every point of the original set lies within this distance of the hull of the kernel
+	double errorBound;
+};
+
+template<class Point>
+struct approximate_convex_hull {
+	// A vertex of the hull, with the same conventions as the result of computeConvexHull3D
+	std::shared_ptr<hullgraph::vertex<Point>> vertex;
+
+	// Every input point lies within this distance of the hull, and the hull lies inside the exact one
+	double errorBound;
+
+	// The number of points the hull was computed from
+	size_t kernelSize;
+};
+
+/*
+ * Selects a small subset of the points of a point source, an epsilon-kernel: in every direction,
+ * the width of the hull of the subset is at least 1 - epsilon times the width of the whole set.
+ * The error is relative to the width in each direction, so a thin set keeps its relative accuracy
+ * across its width as well as along its length.
+ * The points are mapped to a frame along a fat simplex of input points and scaled so that their
+ * bounding box is the unit cube, which changes the widths of the points and of the subset by the
+ * same factor. The cube is split into square columns, and the lowest and the highest point of
+ * each column are kept. The columns are as wide as the points allow: the difference body of a
+ * few extreme points bounds the widths of the whole set from below, in every direction at once.
+ * Coplanar points are split into strips in their plane, and collinear points keep their extremes.
+ * This takes about ten linear passes over the points, run in parallel as set by the execution
+ * policy, and keeps O(1 / epsilon^2) points. Each thread keeps two entries for every column, so it
+ * uses O(1 / epsilon^2) memory.
+ */
+template<class Source>
+epsilon_kernel<point_source_element_t<Source>> computeEpsilonKernel(const Source& points, double epsilon, const execution_policy& execution = execution_policy()) {
+	using Point = point_source_element_t<Source>;
+
+	epsilon_kernel<Point> kernel;
+	kernel.errorBound = 0;
+
+	if (points.size() == 0 || !(epsilon > 0)) {
+		kernel.points.reserve(points.size());
+		for (size_t i = 0; i < points.size(); i++) {
+			kernel.points.push_back(points[i]);
+		}
+
+		return kernel;
+	}
+
+	// Equal or collinear points are represented exactly by their extremes
+	std::vector<size_t> simplex = findExtremeSimplex(points, execution);
+	if (simplex.size() < 3) {
+		for (size_t index : simplex) {
+			kernel.points.push_back(points[index]);
+		}
+
+		return kernel;
+	}
+
+	auto toDouble = [&](size_t index) {
+		const auto& thePoint = points[index];
+		return point<double>{ double(thePoint.x), double(thePoint.y), double(thePoint.z) };
+	};
+
+	auto normalize = [](const point<double>& theVector) {
+		double length = std::sqrt(scalarProduct(theVector, theVector));
+		return point<double>{ theVector.x / length, theVector.y / length, theVector.z / length };
+	};
+
+	execution_policy blockExecution = execution.forItems(points.size());
+
+	// Returns the index with the largest score, with ties going to the smallest index
+	auto findFarthest = [&](auto score) {
+		std::vector<size_t> blockBest(blockExecution.threadCount, 0);
+		std::vector<double> blockScore(blockBest.size(), -std::numeric_limits<double>::infinity());
+		size_t blockCount = parallelBlocks(points.size(), blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				double value = score(toDouble(i));
+				if (value > blockScore[blockIndex]) {
+					blockScore[blockIndex] = value;
+					blockBest[blockIndex] = i;
+				}
+			}
+		});
+
+		size_t best = 0;
+		for (size_t blockIndex = 1; blockIndex < blockCount; blockIndex++) {
+			if (blockScore[blockIndex] > blockScore[best]) {
+				best = blockIndex;
+			}
+		}
+
+		return blockBest[best];
+	};
+
+	// An orthonormal frame along a fat simplex: the point farthest from the first extreme point,
+	// then the point farthest from the line through those two, then the one farthest from their
+	// plane. The first edge is at least half of the diameter, and the bounding box of the points
+	// in this frame is within a constant factor of the simplex in each direction.
+	std::vector<size_t> corners = { simplex[0] };
+	point<double> origin = toDouble(simplex[0]);
+	point<double> axes[3];
+
+	corners.push_back(findFarthest([&](const point<double>& thePoint) {
+		point<double> offset = thePoint - origin;
+		return scalarProduct(offset, offset);
+	}));
+	axes[0] = normalize(toDouble(corners[1]) - origin);
+
+	auto offLine = [&](const point<double>& thePoint) {
+		point<double> offset = thePoint - origin;
+		double along = scalarProduct(offset, axes[0]);
+		return point<double>{ offset.x - along * axes[0].x, offset.y - along * axes[0].y, offset.z - along * axes[0].z };
+	};
+
+	corners.push_back(findFarthest([&](const point<double>& thePoint) {
+		point<double> offset = offLine(thePoint);
+		return scalarProduct(offset, offset);
+	}));
+	axes[1] = normalize(offLine(toDouble(corners[2])));
+	axes[2] = vectorProduct(axes[0], axes[1]);
+
+	if (simplex.size() == 4) {
+		corners.push_back(findFarthest([&](const point<double>& thePoint) {
+			return std::abs(scalarProduct(thePoint - origin, axes[2]));
+		}));
+	}
+
+	auto frameCoordinate = [&](size_t index, int axis) {
+		return scalarProduct(axes[axis], toDouble(index) - origin);
+	};
+
+	// Bounding box in the frame, and the points which attain it, for each block of points
+	std::vector<std::vector<size_t>> blockExtremes(blockExecution.threadCount);
+	size_t blockCount = parallelBlocks(points.size(), blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+		std::vector<size_t> extremes(6, begin);
+		for (size_t i = begin + 1; i < end; i++) {
+			for (int axis = 0; axis < 3; axis++) {
+				double coordinate = frameCoordinate(i, axis);
+				if (coordinate < frameCoordinate(extremes[2 * axis], axis)) {
+					extremes[2 * axis] = i;
+				}
+				if (coordinate > frameCoordinate(extremes[2 * axis + 1], axis)) {
+					extremes[2 * axis + 1] = i;
+				}
+			}
+		}
+
+		blockExtremes[blockIndex].swap(extremes);
+	});
+
+	std::vector<size_t> extremes = blockExtremes[0];
+	for (size_t blockIndex = 1; blockIndex < blockCount; blockIndex++) {
+		for (int axis = 0; axis < 3; axis++) {
+			if (frameCoordinate(blockExtremes[blockIndex][2 * axis], axis) < frameCoordinate(extremes[2 * axis], axis)) {
+				extremes[2 * axis] = blockExtremes[blockIndex][2 * axis];
+			}
+			if (frameCoordinate(blockExtremes[blockIndex][2 * axis + 1], axis) > frameCoordinate(extremes[2 * axis + 1], axis)) {
+				extremes[2 * axis + 1] = blockExtremes[blockIndex][2 * axis + 1];
+			}
+		}
+	}
+
+	// Coplanar points have no extent along the third axis, which is then left unscaled
+	double low[3], extents[3];
+	for (int axis = 0; axis < 3; axis++) {
+		low[axis] = frameCoordinate(extremes[2 * axis], axis);
+		double extent = frameCoordinate(extremes[2 * axis + 1], axis) - low[axis];
+		extents[axis] = corners.size() == 4 && extent > 0 ? extent : 1;
+	}
+
+	auto scaledPoint = [&](size_t index) {
+		point<double> scaled;
+		scaled.x = (frameCoordinate(index, 0) - low[0]) / extents[0];
+		scaled.y = (frameCoordinate(index, 1) - low[1]) / extents[1];
+		scaled.z = corners.size() == 4 ? (frameCoordinate(index, 2) - low[2]) / extents[2] : 0;
+		return scaled;
+	};
+
+	// The points extreme towards the corners of the unit cube round off the bounding box
+	for (int corner = 0; corner < (corners.size() == 4 ? 8 : 4); corner++) {
+		point<double> direction = { corner & 1 ? 1.0 : -1.0, corner & 2 ? 1.0 : -1.0, corner & 4 ? 1.0 : -1.0 };
+		extremes.push_back(findFarthest([&](const point<double>& thePoint) {
+			point<double> offset = thePoint - origin;
+			point<double> scaled = { scalarProduct(axes[0], offset) / extents[0], scalarProduct(axes[1], offset) / extents[1], corners.size() == 4 ? scalarProduct(axes[2], offset) / extents[2] : 0 };
+			return scalarProduct(direction, scaled);
+		}));
+	}
+
+	// The points are split into columns along the last axis of the frame, or into strips along
+	// the second axis if they are coplanar. Any point of a column is off the segment between the
+	// lowest and the highest point of the column by at most the cell size along each other axis,
+	// so the hull of the kernel loses at most twice the support of that square of offsets from
+	// the width in any direction. The support of the difference body of the points, the set of
+	// their differences, is their width, so the kernel is close enough if the square, scaled by
+	// 2 / epsilon, fits into the difference body. It is enough to check its corners.
+	bool isPlanar = corners.size() < 4;
+	int heightAxis = isPlanar ? 1 : 2;
+	std::vector<point<double>> crossSection;
+	if (isPlanar) {
+		crossSection = { { 1, 0, 0 } };
+	}
+	else {
+		crossSection = { { 1, 1, 0 }, { 1, -1, 0 } };
+	}
+
+	// The difference body of the points contains that of the simplex and the extreme points. A
+	// difference body is bounded by the planes across the faces and pairs of edges of the
+	// polytope, so trying the planes through three of the points and the directions across two
+	// segments between them finds how far it reaches along each corner of the cross section.
+	std::vector<point<double>> scaledPoints;
+	for (size_t index : corners) {
+		scaledPoints.push_back(scaledPoint(index));
+	}
+	for (size_t index : extremes) {
+		scaledPoints.push_back(scaledPoint(index));
+	}
+
+	double reach = std::numeric_limits<double>::infinity();
+	auto tryDirection = [&](const point<double>& direction) {
+		double lowest = std::numeric_limits<double>::infinity(), highest = -lowest;
+		for (const auto& scaled : scaledPoints) {
+			lowest = std::min(lowest, scalarProduct(direction, scaled));
+			highest = std::max(highest, scalarProduct(direction, scaled));
+		}
+
+		for (const auto& corner : crossSection) {
+			double along = std::abs(scalarProduct(direction, corner));
+			if (along > 0) {
+				reach = std::min(reach, (highest - lowest) / along);
+			}
+		}
+	};
+
+	std::vector<point<double>> segments;
+	for (size_t i = 0; i < scaledPoints.size(); i++) {
+		for (size_t j = i + 1; j < scaledPoints.size(); j++) {
+			segments.push_back(scaledPoints[j] - scaledPoints[i]);
+		}
+	}
+
+	if (isPlanar) {
+		for (const auto& segment : segments) {
+			tryDirection({ -segment.y, segment.x, 0 });
+		}
+	}
+	else {
+		for (size_t i = 0; i < segments.size(); i++) {
+			for (size_t j = i + 1; j < segments.size(); j++) {
+				tryDirection(vectorProduct(segments[i], segments[j]));
+			}
+		}
+	}
+
+	double cellSize = epsilon * reach / 2;
+	size_t cellCount = size_t(1 / cellSize) + 1;
+	size_t columnCount = isPlanar ? cellCount : cellCount * cellCount;
+	const size_t none = std::numeric_limits<size_t>::max();
+
+	// The lowest and the highest point of each column, first for each block separately
+	std::vector<std::vector<size_t>> blockLowest(blockCount), blockHighest(blockCount);
+	parallelBlocks(points.size(), blockExecution.limitedTo(blockCount), [&](size_t blockIndex, size_t begin, size_t end) {
+		std::vector<size_t> lowest(columnCount, none), highest(columnCount, none);
+		for (size_t i = begin; i < end; i++) {
+			point<double> scaled = scaledPoint(i);
+			size_t column = std::min(cellCount - 1, size_t(std::max(0.0, scaled.x) / cellSize));
+			if (!isPlanar) {
+				column = column * cellCount + std::min(cellCount - 1, size_t(std::max(0.0, scaled.y) / cellSize));
+			}
+
+			double height = frameCoordinate(i, heightAxis);
+			if (lowest[column] == none || height < frameCoordinate(lowest[column], heightAxis)) {
+				lowest[column] = i;
+			}
+			if (highest[column] == none || height > frameCoordinate(highest[column], heightAxis)) {
+				highest[column] = i;
+			}
+		}
+
+		blockLowest[blockIndex].swap(lowest);
+		blockHighest[blockIndex].swap(highest);
+	});
+
+	std::vector<size_t> kernelIndices;
+	for (size_t column = 0; column < columnCount; column++) {
+		size_t lowest = none, highest = none;
+		for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+			size_t candidate = blockLowest[blockIndex][column];
+			if (candidate != none && (lowest == none || frameCoordinate(candidate, heightAxis) < frameCoordinate(lowest, heightAxis))) {
+				lowest = candidate;
+			}
+
+			candidate = blockHighest[blockIndex][column];
+			if (candidate != none && (highest == none || frameCoordinate(candidate, heightAxis) > frameCoordinate(highest, heightAxis))) {
+				highest = candidate;
+			}
+		}
+
+		if (lowest != none) {
+			kernelIndices.push_back(lowest);
+			if (highest != lowest) {
+				kernelIndices.push_back(highest);
+			}
+		}
+	}
+
+	std::sort(kernelIndices.begin(), kernelIndices.end());
+	for (size_t index : kernelIndices) {
+		kernel.points.push_back(points[index]);
+	}
+
+	// A cross section of the columns is a rectangle, or a strip a segment, once scaled back
+	kernel.errorBound = isPlanar ? cellSize * extents[0] : cellSize * std::sqrt(extents[0] * extents[0] + extents[1] * extents[1]);
+	return kernel;
+}
+
+/*
+ * Computes a convex hull whose width in every direction is at least 1 - epsilon times that of
+ * the exact hull, see computeEpsilonKernel. Only the points of the kernel go through the exact
+ * algorithm, with the given options, so for large inputs this is much faster than
+ * computeConvexHull3D. The kernel is selected with the execution policy of the options. The
+ * vertices of the hull are input points.
+ */
+template<class Source>
+approximate_convex_hull<point_source_element_t<Source>> computeApproximateConvexHull3D(const Source& points, double epsilon, const convex_hull_options& options) {
+	using Point = point_source_element_t<Source>;
+
+	epsilon_kernel<Point> kernel = computeEpsilonKernel(points, epsilon, options.execution);
+
+	approximate_convex_hull<Point> result;
+	result.vertex = computeConvexHull3D(kernel.points, options);
+	result.errorBound = kernel.errorBound;
+	result.kernelSize = kernel.points.size();
+	return result;
+}
+
+template<class Source>
+approximate_convex_hull<point_source_element_t<Source>> computeApproximateConvexHull3D(const Source& points, double epsilon, const execution_policy& execution = execution_policy()) {
+	convex_hull_options options;
+	options.execution = execution;
+	return computeApproximateConvexHull3D(points, epsilon, options);
+}
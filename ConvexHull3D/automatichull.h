@@ -0,0 +1,78 @@
+#pragma once
+
+#include "hull3d.h"
+
+#include <array>
+#include <set>
+
+/*
+ * Computes the same hull as computeConvexHull3D, first dropping the points which are strictly
+ * inside of the hull of a random sample of 1024 of them, unless more than half of the sample are
+ * vertices of that hull. Such points can't be on the hull of all points, and testing them against
+ * the faces of the sample hull, in parallel as set by the execution policy of the options, is much
+ * cheaper than adding them to the hull. So when the hull has few vertices compared to the number
+ * of points, most of them never reach the hull algorithm. When most of the points are on the hull,
+ * this only adds the hull of the sample.
+ * This isn't output-sensitive in the O(n log h) sense, the points left after the test still go
+ * through the randomized incremental algorithm.
+ */
+template<class Source>
+std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>> computeConvexHull3DAutomatic(const Source& points, const convex_hull_options& options = convex_hull_options()) {
+	using Point = point_source_element_t<Source>;
+	using F = decltype(Point::x);
+
+	const size_t sampleSize = 1024;
+	if (points.size() < 8 * sampleSize) {
+		return computeConvexHull3D(points, options);
+	}
+
+	std::mt19937_64 rngEngine(points.size());
+	std::uniform_int_distribution<size_t> indexGen(0, points.size() - 1);
+	std::vector<Point> sample(sampleSize);
+	for (Point& samplePoint : sample) {
+		samplePoint = points[indexGen(rngEngine)];
+	}
+
+	auto sampleVertex = computeConvexHull3D(sample);
+	std::set<std::shared_ptr<hullgraph::vertex<Point>>> sampleHullVertices;
+	std::vector<std::array<Point, 3>> sampleFaces;
+	std::set<std::shared_ptr<hullgraph::face<Point>>> visitedFaces;
+	for (const auto& theEdge : hullgraph::exploreGraph(sampleVertex)) {
+		sampleHullVertices.insert(theEdge->origin());
+		if (visitedFaces.insert(theEdge->incidentFace()).second) {
+			sampleFaces.push_back({ theEdge->origin()->data(), theEdge->next()->origin()->data(), theEdge->next()->next()->origin()->data() });
+		}
+	}
+
+	hullgraph::destroyGraph(sampleVertex);
+
+	// A collinear sample has no faces to test against. A flat one has no inside, so then no point is dropped.
+	if (sampleFaces.empty() || sampleHullVertices.size() * 2 > sampleSize) {
+		return computeConvexHull3D(points, options);
+	}
+
+	// Each point is tested against all faces of the sample hull, so smaller blocks pay off
+	execution_policy blockExecution = options.execution.forItems(points.size(), 1 << 10);
+	std::vector<std::vector<size_t>> blockKeptIndices(blockExecution.threadCount);
+	size_t blockCount = parallelBlocks(points.size(), blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+		std::vector<size_t>& keptIndices = blockKeptIndices[blockIndex];
+		for (size_t i = begin; i < end; i++) {
+			const auto& thePoint = points[i];
+			bool isInside = true;
+			for (size_t k = 0; k < sampleFaces.size() && isInside; k++) {
+				isInside = orientation(sampleFaces[k][0], sampleFaces[k][1], sampleFaces[k][2], thePoint) < F(0);
+			}
+
+			if (!isInside) {
+				keptIndices.push_back(i);
+			}
+		}
+	});
+
+	std::vector<size_t> keptIndices;
+	for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+		keptIndices.insert(keptIndices.end(), blockKeptIndices[blockIndex].begin(), blockKeptIndices[blockIndex].end());
+	}
+
+	return computeConvexHull3D(indexed_point_source<Source>{ points, keptIndices }, options);
+}
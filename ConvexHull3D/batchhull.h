@@ -0,0 +1,99 @@
+#pragma once
+
+#include "indexedhull.h"
+
+#include <numeric>
+
+/*
+ * The convex hulls of many point sets, stored back to back. The faces of hull i are
+ * faceOffsets[i] to faceOffsets[i + 1], and the vertices of face f are
+ * faceVertices[vertexOffsets[f]] to faceVertices[vertexOffsets[f + 1]], in the same order as the
+ * faces of computeConvexHull3D. Vertices are indices into the point set of their hull.
+ */
+struct convex_hull_batch {
+	std::vector<size_t> faceOffsets;
+	std::vector<size_t> vertexOffsets;
+	std::vector<size_t> faceVertices;
+
+	size_t size() const {
+		return faceOffsets.size() - 1;
+	}
+};
+
+/*
+ * Computes the hull of each set with computeHull(workspace, setIndex, options) in parallel, see
+ * computeConvexHull3DBatch, and stores them in a batch.
+ */
+template<class F, class ComputeHull>
+convex_hull_batch computeHullBatch(const std::vector<size_t>& setSizes, const convex_hull_options& options, ComputeHull computeHull) {
+	size_t setCount = setSizes.size();
+	std::vector<size_t> order(setCount);
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		return setSizes[a] > setSizes[b];
+	});
+
+	// The threads are already busy with other sets, the hulls themselves run on one thread each
+	convex_hull_options hullOptions = options;
+	hullOptions.execution = sequentialExecution();
+
+	std::vector<convex_hull_indices> hulls(setCount);
+	execution_policy setExecution = options.execution.limitedTo(setCount);
+	std::vector<hull_workspace<labeled_point<F, size_t>>> workspaces(setExecution.threadCount);
+	parallelForEach(setCount, setExecution, [&](size_t threadIndex, size_t itemIndex) {
+		size_t setIndex = order[itemIndex];
+		hulls[setIndex] = computeHull(workspaces[threadIndex], setIndex, hullOptions);
+	});
+
+	convex_hull_batch result;
+	result.faceOffsets.push_back(0);
+	result.vertexOffsets.push_back(0);
+	for (const convex_hull_indices& hull : hulls) {
+		for (const std::vector<size_t>& faceIndices : hull.faces) {
+			result.faceVertices.insert(result.faceVertices.end(), faceIndices.begin(), faceIndices.end());
+			result.vertexOffsets.push_back(result.faceVertices.size());
+		}
+
+		result.faceOffsets.push_back(result.vertexOffsets.size() - 1);
+	}
+
+	return result;
+}
+
+/*
+ * Computes the convex hulls of the point sets stored back to back in points, where set i is
+ * points[offsets[i]] to points[offsets[i + 1]]. The hulls are computed in parallel as set by
+ * options.execution, each thread with its own hull_workspace, and the largest
+ * sets are started first so that the threads finish at about the same time. Each hull is computed
+ * on a single thread, the same way as computeConvexHull3DIndices would compute it.
+ */
+template<class Source>
+convex_hull_batch computeConvexHull3DBatch(const Source& points, const std::vector<size_t>& offsets, const convex_hull_options& options = convex_hull_options()) {
+	using F = decltype(point_source_element_t<Source>::x);
+
+	std::vector<size_t> setSizes;
+	for (size_t i = 0; i + 1 < offsets.size(); i++) {
+		setSizes.push_back(offsets[i + 1] - offsets[i]);
+	}
+
+	return computeHullBatch<F>(setSizes, options, [&](auto& workspace, size_t setIndex, const convex_hull_options& hullOptions) {
+		return computeConvexHull3DIndices(workspace, range_point_source<Source>{ points, offsets[setIndex], setSizes[setIndex] }, hullOptions);
+	});
+}
+
+/*
+ * Computes the convex hulls of the given point sets, see the overload taking offsets.
+ */
+template<class Point>
+convex_hull_batch computeConvexHull3DBatch(const std::vector<std::vector<Point>>& pointSets, const convex_hull_options& options = convex_hull_options()) {
+	using F = decltype(Point::x);
+
+	std::vector<size_t> setSizes;
+	for (const std::vector<Point>& pointSet : pointSets) {
+		setSizes.push_back(pointSet.size());
+	}
+
+	return computeHullBatch<F>(setSizes, options, [&](auto& workspace, size_t setIndex, const convex_hull_options& hullOptions) {
+		return computeConvexHull3DIndices(workspace, pointSets[setIndex], hullOptions);
+	});
+}
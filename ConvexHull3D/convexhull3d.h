@@ -1 +1,16 @@
+#pragma once
+
 #include "voronoi.h"
+#include "dynamichull.h"
+#include "streaminghull.h"
+#include "approxhull.h"
+#include "automatichull.h"
+#include "indexedhull.h"
+#include "smallhull.h"
+#include "batchhull.h"
+#include "warmhull.h"
+#include "windowhull.h"
+#include "convexlayers.h"
+#include "mergehull.h"
+#include "shardedhull.h"
+#include "resultcache.h"
@@ -0,0 +1,283 @@
+#pragma once
+
+#include "indexedhull.h"
+#include "warmhull.h"
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <set>
+
+/*
+ * Computes the convex layers of the points, peeling them like an onion: layer 0 is made of the
+ * vertices of their hull, layer 1 of the vertices of the hull of the rest, and so on until no
+ * points are left. Returns the layer of each point. Of equal points, only one is a vertex of each
+ * layer, the others are in the layers below. When the points left are coplanar, the points on the
+ * sides of their polygon are in the layer, and when they are collinear, the two extremes are.
+ *
+ * Peeling computes one hull per layer, but only over the points near the outside. Every now and
+ * then, a core is built from the points deep inside: the hull of points spread over a shell
+ * below the outside band, and the points strictly inside of it, which can't be vertices of any
+ * hull while the vertices of the core are still there. The layers are computed without them.
+ * When a vertex of the core is peeled, the core shrinks to the hull of its other vertices and
+ * only the points which are no longer inside of it come back, and once too many have, the core
+ * is built again from the points left. How deep the points are is measured against the faces of
+ * the last layer, scaled around the centroid of the points left, so that the shell follows the
+ * shape of the layers and lasts for many of them.
+ */
+template<class Source>
+std::vector<size_t> computeConvexLayers3D(const Source& points, const convex_hull_options& options = convex_hull_options()) {
+	using namespace hullgraph;
+	using F = decltype(point_source_element_t<Source>::x);
+	using hull_point = labeled_point<F, size_t>;
+
+	size_t n = points.size();
+	const size_t none = std::numeric_limits<size_t>::max();
+	std::vector<size_t> layers(n, none);
+
+	// With fewer points near the outside than this, the core isn't worth building
+	const size_t minBandSize = 1 << 9;
+
+	// The core is the hull of at most this many points of the shell, and the depths are measured
+	// against at most this many faces of the last layer, which is plenty for ranking the points
+	const size_t maxCoreSize = 1 << 10;
+	const size_t maxDepthFaces = 1 << 8;
+
+	// Testing a point against the planes of a layer takes more than a few operations, so the
+	// blocks of those passes are smaller than the default
+	const size_t minBlockSize = 1 << 12;
+
+	index_labeled_point_source<Source> labeledPoints{ points };
+
+	// The points left but the ones strictly inside the core, and the points strictly inside it
+	std::vector<size_t> active(n);
+	std::iota(active.begin(), active.end(), size_t(0));
+	std::vector<size_t> deep;
+	std::vector<size_t> coreVertices;
+	std::vector<bool> isCoreVertex(n);
+
+	// The faces of the core, each as the sorted indices of its vertices
+	std::set<std::vector<size_t>> coreFaces;
+
+	/*
+	 * Lists the planes of the faces of a full-dimensional hull, and their vertices in faceVertices
+	 * if it's given.
+	 */
+	auto facePlanes = [&](const incremental_convex_hull<hull_point>& hull, std::vector<std::vector<size_t>>* faceVertices = nullptr) {
+		std::vector<face_plane<F>> planes;
+		std::unordered_set<std::shared_ptr<face<hull_point>>> visitedFaces;
+		for (const auto& theEdge : exploreGraph(hull.vertex())) {
+			if (visitedFaces.insert(theEdge->incidentFace()).second) {
+				const hull_point& a = theEdge->origin()->data();
+				const hull_point& b = theEdge->destination()->data();
+				const hull_point& c = theEdge->next()->destination()->data();
+				point<F> normal = vectorProduct(b - a, c - a);
+				planes.push_back({ { a.x, a.y, a.z }, normal, 1 / std::sqrt(double(scalarProduct(normal, normal))) });
+				if (faceVertices) {
+					std::vector<size_t> indices;
+					for (const auto& faceEdge : faceToEdgeList(theEdge->incidentFace())) {
+						indices.push_back(faceEdge->origin()->data().label);
+					}
+					std::sort(indices.begin(), indices.end());
+					faceVertices->push_back(indices);
+				}
+			}
+		}
+
+		return planes;
+	};
+
+	/*
+	 * Makes the full-dimensional hull the core. Its vertices become active, and of the candidates,
+	 * which aren't active, the ones strictly inside of it are deep and the others become active.
+	 * The candidates should be strictly inside of the faces the hull shares with the previous
+	 * core, so only the other faces are checked.
+	 */
+	auto setCore = [&](const incremental_convex_hull<hull_point>& coreHull, const std::vector<size_t>& candidates) {
+		for (size_t index : coreVertices) {
+			isCoreVertex[index] = false;
+		}
+		coreVertices.clear();
+		for (const hull_point& vertex : coreHull.vertices()) {
+			coreVertices.push_back(vertex.label);
+			isCoreVertex[vertex.label] = true;
+		}
+
+		std::vector<std::vector<size_t>> faceVertices;
+		std::vector<face_plane<F>> allPlanes = facePlanes(coreHull, &faceVertices);
+		std::vector<face_plane<F>> planes;
+		for (size_t k = 0; k < allPlanes.size(); k++) {
+			if (!coreFaces.count(faceVertices[k])) {
+				planes.push_back(allPlanes[k]);
+			}
+		}
+		coreFaces = std::set<std::vector<size_t>>(faceVertices.begin(), faceVertices.end());
+		std::vector<char> isInside(candidates.size());
+		execution_policy blockExecution = options.execution.forItems(candidates.size(), minBlockSize);
+		parallelBlocks(candidates.size(), blockExecution, [&](size_t, size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				const auto& thePoint = points[candidates[i]];
+				point<F> coordinates = { thePoint.x, thePoint.y, thePoint.z };
+				bool isStrictlyInside = true;
+				for (size_t k = 0; k < planes.size() && isStrictlyInside; k++) {
+					isStrictlyInside = scalarProduct(planes[k].normal, coordinates - planes[k].origin) < F(0);
+				}
+				isInside[i] = isStrictlyInside;
+			}
+		});
+
+		deep.clear();
+		for (size_t i = 0; i < candidates.size(); i++) {
+			if (isInside[i] && !isCoreVertex[candidates[i]]) {
+				deep.push_back(candidates[i]);
+			}
+			else {
+				active.push_back(candidates[i]);
+			}
+		}
+		std::sort(active.begin(), active.end());
+	};
+
+	auto dissolveCore = [&]() {
+		for (size_t index : coreVertices) {
+			isCoreVertex[index] = false;
+		}
+		coreVertices.clear();
+		coreFaces.clear();
+		active.insert(active.end(), deep.begin(), deep.end());
+		deep.clear();
+		std::sort(active.begin(), active.end());
+	};
+
+	/*
+	 * Builds the core from the active points, which are all points left and lie inside of the
+	 * hull of the last layer. The bandSize points closest to its faces stay active, the next
+	 * bandSize points make up the shell. Leaves everything as it was if the core is flat.
+	 */
+	auto buildCore = [&](const incremental_convex_hull<hull_point>& layerHull, size_t bandSize) {
+		point<double> centroid = { 0, 0, 0 };
+		for (size_t index : active) {
+			const auto& thePoint = points[index];
+			centroid.x += double(thePoint.x) / double(active.size());
+			centroid.y += double(thePoint.y) / double(active.size());
+			centroid.z += double(thePoint.z) / double(active.size());
+		}
+
+		// Each face as its normal divided by how far the face is from the centroid along it
+		std::vector<point<double>> scaledNormals;
+		std::vector<face_plane<F>> layerPlanes = facePlanes(layerHull);
+		size_t faceStride = std::max(size_t(1), layerPlanes.size() / maxDepthFaces);
+		for (size_t k = 0; k < layerPlanes.size(); k += faceStride) {
+			const face_plane<F>& plane = layerPlanes[k];
+			point<double> normal = { double(plane.normal.x), double(plane.normal.y), double(plane.normal.z) };
+			double reach = scalarProduct(normal, point<double>{ double(plane.origin.x), double(plane.origin.y), double(plane.origin.z) } - centroid);
+			if (!(reach > 0)) {
+				return;
+			}
+			scaledNormals.push_back({ normal.x / reach, normal.y / reach, normal.z / reach });
+		}
+
+		// The depth of a point is the scale of the hull which has it on its boundary
+		std::vector<std::pair<double, size_t>> depths(active.size());
+		execution_policy blockExecution = options.execution.forItems(active.size(), minBlockSize);
+		parallelBlocks(active.size(), blockExecution, [&](size_t, size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				const auto& thePoint = points[active[i]];
+				point<double> offset = point<double>{ double(thePoint.x), double(thePoint.y), double(thePoint.z) } - centroid;
+				double scale = 0;
+				for (const point<double>& scaledNormal : scaledNormals) {
+					scale = std::max(scale, scalarProduct(scaledNormal, offset));
+				}
+				depths[i] = { scale, active[i] };
+			}
+		});
+
+		// From the inside out: the inner points, the shell and the band. The core is the hull of
+		// points spread over the shell, with fewer vertices it has fewer faces to check the points
+		// against and fewer vertices which can be peeled.
+		size_t innerSize = active.size() - 2 * bandSize;
+		std::nth_element(depths.begin(), depths.begin() + innerSize + bandSize, depths.end());
+		std::nth_element(depths.begin(), depths.begin() + innerSize, depths.begin() + innerSize + bandSize);
+		std::vector<size_t> coreIndices;
+		size_t shellStride = std::max(size_t(1), bandSize / maxCoreSize);
+		for (size_t i = innerSize; i < innerSize + bandSize; i += shellStride) {
+			coreIndices.push_back(depths[i].second);
+		}
+
+		incremental_convex_hull<hull_point> coreHull(options);
+		coreHull.insert(indexed_point_source<index_labeled_point_source<Source>>{ labeledPoints, coreIndices });
+		if (coreHull.isFullDimensional()) {
+			std::vector<size_t> candidates;
+			for (size_t i = 0; i < innerSize + bandSize; i++) {
+				candidates.push_back(depths[i].second);
+			}
+
+			active.clear();
+			for (size_t i = innerSize + bandSize; i < depths.size(); i++) {
+				active.push_back(depths[i].second);
+			}
+			setCore(coreHull, candidates);
+		}
+		destroyGraph(coreHull.vertex());
+	};
+
+	/*
+	 * Shrinks the core to the hull of its vertices which weren't peeled, after some of them were.
+	 * Only the deep points near the peeled vertices become active, which is usually much less work
+	 * than building the core again.
+	 */
+	auto shrinkCore = [&]() {
+		std::vector<size_t> remainingCoreVertices;
+		for (size_t index : coreVertices) {
+			if (layers[index] == none) {
+				remainingCoreVertices.push_back(index);
+			}
+		}
+
+		incremental_convex_hull<hull_point> coreHull(options);
+		coreHull.insert(indexed_point_source<index_labeled_point_source<Source>>{ labeledPoints, remainingCoreVertices });
+		if (coreHull.isFullDimensional()) {
+			std::vector<size_t> candidates;
+			candidates.swap(deep);
+			setCore(coreHull, candidates);
+		}
+		else {
+			dissolveCore();
+		}
+		destroyGraph(coreHull.vertex());
+	};
+
+	for (size_t layer = 0; !active.empty(); layer++) {
+		incremental_convex_hull<hull_point> layerHull(options);
+		layerHull.insert(indexed_point_source<index_labeled_point_source<Source>>{ labeledPoints, active });
+		bool isCorePeeled = false;
+		for (const hull_point& vertex : layerHull.vertices()) {
+			layers[vertex.label] = layer;
+			isCorePeeled |= isCoreVertex[vertex.label];
+		}
+
+		active.erase(std::remove_if(active.begin(), active.end(), [&](size_t index) {
+			return layers[index] != none;
+		}), active.end());
+
+		// The points near the peeled vertices of the core could be vertices of the next hull
+		if (isCorePeeled) {
+			shrinkCore();
+		}
+
+		// A band of about the square root of the points left keeps both the hulls of the layers
+		// and the number of times the core is built small. Once the core has shrunk so much that
+		// the active points are several bands, it's built again. Points within the tolerance of a
+		// face aren't always vertices, which the core doesn't account for, so it's only used
+		// without one.
+		size_t bandSize = std::max(minBandSize, size_t(std::sqrt(double(active.size() + deep.size())) * 8));
+		bool isCoreWorthBuilding = active.size() + deep.size() > 4 * bandSize && (coreVertices.empty() || active.size() > 3 * bandSize);
+		if (options.coplanarityTolerance <= 0 && layerHull.isFullDimensional() && isCoreWorthBuilding) {
+			dissolveCore();
+			buildCore(layerHull, bandSize);
+		}
+		destroyGraph(layerHull.vertex());
+	}
+
+	return layers;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "pointsource.h"
+#include "parallel.h"
+
+#include <tuple>
+#include <numeric>
+
+/*
+ * The distinct points of a point source. Each group of equal points is represented by the one
+ * with the smallest index.
+ */
+struct deduplicated_points {
+	// The indices of the representatives, in increasing order
+	std::vector<size_t> representatives;
+
+	// For each index of the input, the index of its representative in the input
+	std::vector<size_t> representativeOf;
+};
+
+/*
+ * Finds the duplicates among the points by sorting their indices, in parallel as set by the
+ * execution policy. Passing indexed_point_source{ points, representatives } to
+ * computeConvexHull3D computes the same hull without ever looking at the duplicates, and the
+ * representativeOf mapping recovers the labels of the points which were left out. The same is
+ * done by the removeDuplicates option of convex_hull_options.
+ */
+template<class Source>
+deduplicated_points deduplicatePoints(const Source& points, const execution_policy& execution = execution_policy()) {
+	size_t n = points.size();
+
+	execution_policy blockExecution = execution.forItems(n);
+
+	std::vector<size_t> order(n);
+	std::iota(order.begin(), order.end(), size_t(0));
+	parallelSort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		const auto& p = points[a];
+		const auto& q = points[b];
+		return std::tie(p.x, p.y, p.z, a) < std::tie(q.x, q.y, q.z, b);
+	}, blockExecution);
+
+	// Equal points are next to each other, the first of each run has the smallest index
+	deduplicated_points result;
+	result.representativeOf.resize(n);
+	for (size_t i = 0; i < n; i++) {
+		bool isDuplicate = false;
+		if (i) {
+			const auto& p = points[order[i - 1]];
+			const auto& q = points[order[i]];
+			isDuplicate = p.x == q.x && p.y == q.y && p.z == q.z;
+		}
+
+		result.representativeOf[order[i]] = isDuplicate ? result.representativeOf[order[i - 1]] : order[i];
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		if (result.representativeOf[i] == i) {
+			result.representatives.push_back(i);
+		}
+	}
+
+	return result;
+}
@@ -2,6 +2,8 @@
 
 #include "hull3d.h"
 
+#include <iterator>
+
 /*
  * Computes whether the given face looks up, i.e. whether its normal vector's z-value
  * is nonnegative.
@@ -21,26 +23,45 @@ bool isFaceDirectedUpOrVertical(const std::shared_ptr<hullgraph::face<Point>>& t
 	return determinant(points[1] - points[0], points[2] - points[0], zPlus) >= F(0);
 }
 
+/*
+ * The points of a planar point source lifted onto the paraboloid z = x^2 + y^2, labeled with their
+ * index. The lifted points are computed whenever they are read, instead of being stored.
+ */
+template<class Source>
+struct paraboloid_point_source {
+	using F = decltype(point_source_element_t<Source>::x);
+
+	const Source& points;
+
+	size_t size() const {
+		return points.size();
+	}
+
+	labeled_point<F, size_t> operator[](size_t index) const {
+		const auto& thePoint = points[index];
+		return labeled_point<F, size_t>(thePoint.x, thePoint.y, thePoint.x * thePoint.x + thePoint.y * thePoint.y, index);
+	}
+};
+
 /*
  * Computes the Delaunay triangulation of a set of points in the plane.
- * The template parameter Point2D should have two members x and y of the same type,
- * which should be a numeric type. Returns the external face of the triangulation graph.
+ * The points can come from any point source, whose points should have two members x and y of
+ * the same type, which should be a numeric type. Returns the external face of the triangulation graph.
+ * The options are passed on to computeConvexHull3D; with removeDuplicates, each group of equal
+ * points is represented in the graph by its first point, as found by deduplicatePoints.
  */
-template<class Point2D>
-std::shared_ptr<hullgraph::face<labeled_point<decltype(Point2D::x), size_t>>> delaunayTriangulation(const std::vector<Point2D>& points) {
+template<class Source>
+std::shared_ptr<hullgraph::face<labeled_point<decltype(point_source_element_t<Source>::x), size_t>>> delaunayTriangulation(
+	const Source& points,
+	const convex_hull_options& options = convex_hull_options())
+{
 	using namespace hullgraph;
-	using F = decltype(Point2D::x);
+	using F = decltype(point_source_element_t<Source>::x);
 	using local_point = labeled_point<F, size_t>;
 
-	std::vector<local_point> paraboloidPoints(points.size());
-	for (size_t i = 0; i < points.size(); i++) {
-		paraboloidPoints[i].x = points[i].x;
-		paraboloidPoints[i].y = points[i].y;
-		paraboloidPoints[i].z = points[i].x * points[i].x + points[i].y * points[i].y;
-		paraboloidPoints[i].label = i;
-	}
+	paraboloid_point_source<Source> paraboloidPoints = { points };
 
-	auto theVertex = computeConvexHull3D(paraboloidPoints);
+	auto theVertex = computeConvexHull3D(paraboloidPoints, options);
 	auto allEdges = exploreGraph(theVertex);
 
 	std::unordered_set<std::shared_ptr<face<local_point>>> facesToJoinSet;
@@ -56,3 +77,87 @@ std::shared_ptr<hullgraph::face<labeled_point<decltype(Point2D::x), size_t>>> de
 	std::vector<std::shared_ptr<face<local_point>>> facesToJoin(facesToJoinSet.begin(), facesToJoinSet.end());
 	return joinFaces(facesToJoin).newFace;
 }
+
+/*
+ * Computes the Delaunay triangulation with the given execution policy instead of the one in the options.
+ */
+template<class Source>
+std::shared_ptr<hullgraph::face<labeled_point<decltype(point_source_element_t<Source>::x), size_t>>> delaunayTriangulation(
+	const execution_policy& execution,
+	const Source& points,
+	const convex_hull_options& options = convex_hull_options())
+{
+	convex_hull_options policyOptions = options;
+	policyOptions.execution = execution;
+	return delaunayTriangulation(points, policyOptions);
+}
+
+/*
+ * A Delaunay triangulation given by the indices of its points in the input.
+ */
+struct delaunay_indices {
+	// Each cell as the indices of its vertices, in the order of its edges in the graph. Cells of
+	// cocircular points can have more than three vertices.
+	std::vector<std::vector<size_t>> cells;
+
+	// The vertices of the external face, which go around the convex hull of the points
+	std::vector<size_t> boundary;
+};
+
+/*
+ * Lists the cells and the boundary of a triangulation computed by delaunayTriangulation, then
+ * destroys its graph. The cells are listed in parallel as set by the execution policy, in the same
+ * order whatever the number of threads.
+ */
+template<class F>
+delaunay_indices extractDelaunayIndices(
+	const std::shared_ptr<hullgraph::face<labeled_point<F, size_t>>>& externalFace,
+	const execution_policy& execution = execution_policy())
+{
+	using namespace hullgraph;
+
+	delaunay_indices result;
+	if (!externalFace || !externalFace->outerComponent()) {
+		return result;
+	}
+
+	for (const auto& theEdge : faceToEdgeList(externalFace)) {
+		result.boundary.push_back(theEdge->origin()->data().label);
+	}
+
+	// Each cell is listed from its outer component, so no set of the cells already listed is needed
+	auto initialVertex = externalFace->outerComponent()->origin();
+	auto allEdges = exploreGraph(initialVertex);
+	execution_policy blockExecution = execution.forItems(allEdges.size(), 1 << 12);
+	std::vector<std::vector<std::vector<size_t>>> blockCells(blockExecution.threadCount);
+	size_t blockCount = parallelBlocks(allEdges.size(), blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+		std::vector<std::shared_ptr<edge<labeled_point<F, size_t>>>> cellEdges;
+		for (size_t i = begin; i < end; i++) {
+			const auto& theEdge = allEdges[i];
+			if (theEdge->incidentFace() != externalFace && theEdge == theEdge->incidentFace()->outerComponent()) {
+				faceToEdgeList(theEdge->incidentFace(), cellEdges);
+				std::vector<size_t> cellIndices;
+				for (const auto& cellEdge : cellEdges) {
+					cellIndices.push_back(cellEdge->origin()->data().label);
+				}
+
+				blockCells[blockIndex].push_back(std::move(cellIndices));
+			}
+		}
+	});
+
+	for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+		std::move(blockCells[blockIndex].begin(), blockCells[blockIndex].end(), std::back_inserter(result.cells));
+	}
+
+	destroyGraph(initialVertex);
+	return result;
+}
+
+/*
+ * Computes the Delaunay triangulation and returns it as indices into the input.
+ */
+template<class Source>
+delaunay_indices delaunayTriangulationIndices(const Source& points, const convex_hull_options& options = convex_hull_options()) {
+	return extractDelaunayIndices(delaunayTriangulation(points, options), options.execution);
+}
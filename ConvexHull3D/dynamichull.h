@@ -0,0 +1,510 @@
+#pragma once
+
+#include "hull3d.h"
+
+/*
+ * Returns true if the point p lies inside the tetrahedron abcd or on its boundary.
+ */
+template<class Point>
+bool insideTetrahedron(const Point& a, const Point& b, const Point& c, const Point& d, const Point& p) {
+	using F = decltype(Point::x);
+
+	auto sameSide = [&](const Point& u, const Point& v, const Point& w, const Point& opposite) {
+		F oppositeOrientation = orientation(u, v, w, opposite);
+		F pointOrientation = orientation(u, v, w, p);
+		return pointOrientation == F(0) || (oppositeOrientation > F(0)) == (pointOrientation > F(0));
+	};
+
+	return sameSide(a, b, c, d) && sameSide(a, b, d, c) && sameSide(a, c, d, b) && sameSide(b, c, d, a);
+}
+
+/*
+ * A convex hull of a set of points which supports both insertion and deletion. Every inserted
+ * point gets an id, and hull vertices carry that id as their label.
+ *
+ * Each point which is not a hull vertex is charged to four other points whose tetrahedron
+ * contains it. They are picked around a random line through the point: the faces where the line
+ * leaves the hull in both directions are found by walking over the graph, and the triangles of
+ * those faces hit by the line span a tetrahedron containing the point. As long as those four
+ * points are present, the charged point can't reach the hull, so only the points charged to an
+ * erased point are ever looked at again, and no point is a witness of all the others.
+ *  - inserting a point inside of the hull walks over the graph to charge it, and inserting a
+ *    point outside of it costs as much as adding it to an incremental_convex_hull,
+ *  - erasing a point which no other point is charged to is O(1),
+ *  - erasing a point other points are charged to charges each of them again with a walk,
+ *  - erasing a hull vertex also computes the hull of its neighbors and of the points which were
+ *    charged to it, and replaces the faces around the vertex with the outer faces of that hull,
+ *    see incremental_convex_hull::eraseVertex. The rest of the graph is left as it is.
+ * Points which couldn't be charged this way are tested against the fan triangulation of the whole
+ * hull around one of its vertices. Points which couldn't be located at all (for example because of
+ * floating point rounding), as well as all points while the set doesn't span the space, are kept
+ * loose and are candidates of every repair. When the hole left by a vertex can't be repaired, as
+ * when the remaining points are coplanar, the hull is built again from its remaining vertices, the
+ * loose points and the points charged to the vertex.
+ */
+template<class F>
+class dynamic_convex_hull {
+public:
+	using hull_point = labeled_point<F, size_t>;
+	using vertexptr = std::shared_ptr<hullgraph::vertex<hull_point>>;
+
+private:
+	using edgeptr = std::shared_ptr<hullgraph::edge<hull_point>>;
+	using faceptr = std::shared_ptr<hullgraph::face<hull_point>>;
+
+	struct point_record {
+		point<F> coordinates;
+		bool alive;
+		bool charged;
+		size_t witnesses[4];
+		size_t witnessPositions[4];
+
+		// The vertex of the point while it's on the hull, invalidated once it isn't anymore
+		vertexptr hullVertex;
+	};
+
+	std::vector<point_record> m_records;
+	std::vector<std::vector<size_t>> m_dependents;
+	std::unordered_set<size_t> m_looseIds;
+	size_t m_size = 0;
+	incremental_convex_hull<hull_point> m_hull;
+	std::mt19937_64 m_rngEngine;
+
+	hull_point makeHullPoint(size_t id) const {
+		const point<F>& p = m_records[id].coordinates;
+		return hull_point(p.x, p.y, p.z, id);
+	}
+
+	static point<double> toDouble(const point<F>& thePoint) {
+		return { double(thePoint.x), double(thePoint.y), double(thePoint.z) };
+	}
+
+	bool isOnHull(size_t id) const {
+		const vertexptr& hullVertex = m_records[id].hullVertex;
+		return m_hull.isFullDimensional() && hullVertex && hullVertex->incidentEdge();
+	}
+
+	void charge(size_t id, const size_t (&witnesses)[4]) {
+		point_record& record = m_records[id];
+		record.charged = true;
+		for (size_t k = 0; k < 4; k++) {
+			record.witnesses[k] = witnesses[k];
+			record.witnessPositions[k] = m_dependents[witnesses[k]].size();
+			m_dependents[witnesses[k]].push_back(id);
+		}
+	}
+
+	void uncharge(size_t id) {
+		point_record& record = m_records[id];
+		if (!record.charged) {
+			return;
+		}
+
+		for (size_t k = 0; k < 4; k++) {
+			std::vector<size_t>& dependents = m_dependents[record.witnesses[k]];
+			size_t movedId = dependents.back();
+			dependents[record.witnessPositions[k]] = movedId;
+			dependents.pop_back();
+
+			if (movedId != id) {
+				point_record& movedRecord = m_records[movedId];
+				for (size_t l = 0; l < 4; l++) {
+					if (movedRecord.witnesses[l] == record.witnesses[k]) {
+						movedRecord.witnessPositions[l] = record.witnessPositions[k];
+					}
+				}
+			}
+		}
+
+		record.charged = false;
+	}
+
+	/*
+	 * Returns the face through which the ray from the point in the given direction leaves the
+	 * hull, found by walking from face to face towards it. Returns null if the point isn't
+	 * strictly inside of the hull, as far as floating point can tell.
+	 */
+	faceptr findExitFace(const point<double>& thePoint, const point<double>& direction) const {
+		bool isUsable = true;
+		auto score = [&](const faceptr& theFace) {
+			edgeptr faceEdge = theFace->outerComponent();
+			point<double> a = toDouble(faceEdge->origin()->data());
+			point<double> b = toDouble(faceEdge->next()->origin()->data());
+			point<double> c = toDouble(faceEdge->next()->destination()->data());
+			point<double> normal = vectorProduct(b - a, c - a);
+			double reach = scalarProduct(normal, a - thePoint);
+			if (!(reach > 0)) {
+				isUsable = false;
+				return 0.0;
+			}
+
+			return scalarProduct(normal, direction) / reach;
+		};
+
+		faceptr current = m_hull.vertex()->incidentEdge()->incidentFace();
+		double value = score(current);
+		for (faceptr previous; previous != current && isUsable;) {
+			previous = current;
+			for (const edgeptr& faceEdge : hullgraph::faceToEdgeList(previous)) {
+				faceptr neighbor = faceEdge->twin()->incidentFace();
+				double neighborValue = score(neighbor);
+				if (neighborValue > value) {
+					current = neighbor;
+					value = neighborValue;
+				}
+			}
+		}
+
+		return isUsable && value > 0 ? current : nullptr;
+	}
+
+	/*
+	 * Adds the ids of the triangle of the fan triangulation of the face which contains the given
+	 * point of its plane, or comes the closest to containing it.
+	 */
+	static void addFanTriangle(const faceptr& theFace, const point<double>& thePoint, std::vector<size_t>& ids) {
+		std::vector<edgeptr> faceEdges = hullgraph::faceToEdgeList(theFace);
+		std::vector<point<double>> corners;
+		for (const edgeptr& faceEdge : faceEdges) {
+			corners.push_back(toDouble(faceEdge->origin()->data()));
+		}
+
+		point<double> normal = vectorProduct(corners[1] - corners[0], corners[2] - corners[0]);
+		auto side = [&](const point<double>& a, const point<double>& b) {
+			return scalarProduct(normal, vectorProduct(b - a, thePoint - a));
+		};
+
+		size_t bestTriangle = 1;
+		double bestValue = -std::numeric_limits<double>::infinity();
+		for (size_t k = 1; k + 1 < corners.size(); k++) {
+			double value = std::min({ side(corners[0], corners[k]), side(corners[k], corners[k + 1]), side(corners[k + 1], corners[0]) });
+			if (value > bestValue) {
+				bestTriangle = k;
+				bestValue = value;
+			}
+		}
+
+		for (size_t k : { size_t(0), bestTriangle, bestTriangle + 1 }) {
+			size_t id = faceEdges[k]->origin()->data().label;
+			if (std::find(ids.begin(), ids.end(), id) == ids.end()) {
+				ids.push_back(id);
+			}
+		}
+	}
+
+	/*
+	 * Charges the given non-hull point to the corners of the triangles a random line through it
+	 * goes through when leaving the hull on both sides. Returns false if they don't contain it.
+	 */
+	bool locateAlongLine(size_t id) {
+		const point<F>& p = m_records[id].coordinates;
+		point<double> start = toDouble(p);
+
+		std::normal_distribution<double> distribution;
+		point<double> direction = { distribution(m_rngEngine), distribution(m_rngEngine), distribution(m_rngEngine) };
+
+		std::vector<size_t> ids;
+		for (double sign : { 1.0, -1.0 }) {
+			point<double> signedDirection = { sign * direction.x, sign * direction.y, sign * direction.z };
+			faceptr exitFace = findExitFace(start, signedDirection);
+			if (!exitFace) {
+				return false;
+			}
+
+			point<double> a = toDouble(exitFace->outerComponent()->origin()->data());
+			point<double> b = toDouble(exitFace->outerComponent()->next()->origin()->data());
+			point<double> c = toDouble(exitFace->outerComponent()->next()->destination()->data());
+			point<double> normal = vectorProduct(b - a, c - a);
+			double t = scalarProduct(normal, a - start) / scalarProduct(normal, signedDirection);
+			addFanTriangle(exitFace, { start.x + t * signedDirection.x, start.y + t * signedDirection.y, start.z + t * signedDirection.z }, ids);
+		}
+
+		// The point lies on a segment between the two triangles, so in a tetrahedron of their corners
+		for (size_t i = 0; i < ids.size(); i++) {
+			for (size_t j = i + 1; j < ids.size(); j++) {
+				for (size_t k = j + 1; k < ids.size(); k++) {
+					for (size_t l = k + 1; l < ids.size(); l++) {
+						const point<F>& a = m_records[ids[i]].coordinates;
+						const point<F>& b = m_records[ids[j]].coordinates;
+						const point<F>& c = m_records[ids[k]].coordinates;
+						const point<F>& d = m_records[ids[l]].coordinates;
+						if (orientation(a, b, c, d) != F(0) && insideTetrahedron(a, b, c, d, p)) {
+							size_t witnesses[4] = { ids[i], ids[j], ids[k], ids[l] };
+							charge(id, witnesses);
+							return true;
+						}
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/*
+	 * Charges the given non-hull point to a tetrahedron of the fan triangulation of the hull
+	 * around one of its vertices. Returns false if it's in none of them.
+	 */
+	bool locateInFan(size_t id) {
+		using namespace hullgraph;
+
+		const point<F>& p = m_records[id].coordinates;
+		vertexptr apexVertex = m_hull.vertex();
+		size_t apex = apexVertex->data().label;
+
+		std::unordered_set<faceptr> visitedFaces;
+		for (const edgeptr& theEdge : exploreGraph(apexVertex)) {
+			faceptr theFace = theEdge->incidentFace();
+			if (!visitedFaces.insert(theFace).second) {
+				continue;
+			}
+
+			std::vector<edgeptr> faceEdges = faceToEdgeList(theFace);
+			bool touchesApex = false;
+			for (const edgeptr& faceEdge : faceEdges) {
+				touchesApex |= faceEdge->origin() == apexVertex;
+			}
+
+			for (size_t k = 1; k + 1 < faceEdges.size() && !touchesApex; k++) {
+				size_t witnesses[4] = { apex, faceEdges[0]->origin()->data().label, faceEdges[k]->origin()->data().label, faceEdges[k + 1]->origin()->data().label };
+				if (insideTetrahedron(m_records[witnesses[0]].coordinates, m_records[witnesses[1]].coordinates, m_records[witnesses[2]].coordinates, m_records[witnesses[3]].coordinates, p)) {
+					charge(id, witnesses);
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/*
+	 * Charges the given non-hull point to a tetrahedron containing it. If no such tetrahedron
+	 * is found, the point is made loose.
+	 */
+	void locate(size_t id) {
+		if (!locateAlongLine(id) && !locateInFan(id)) {
+			m_looseIds.insert(id);
+		}
+	}
+
+	/*
+	 * Stores the vertices of the current graph in their records.
+	 */
+	void markHullVertices() {
+		for (const edgeptr& theEdge : hullgraph::exploreGraph(m_hull.vertex())) {
+			m_records[theEdge->origin()->data().label].hullVertex = theEdge->origin();
+		}
+	}
+
+	/*
+	 * Charges the given points, or makes them loose if they can't be charged. Hull vertices and
+	 * points which are already charged are skipped.
+	 */
+	void settle(const std::vector<size_t>& ids) {
+		for (size_t id : ids) {
+			if (m_records[id].charged) {
+				continue;
+			}
+
+			m_looseIds.erase(id);
+			if (!m_records[id].alive || isOnHull(id)) {
+				continue;
+			}
+
+			if (m_hull.isFullDimensional()) {
+				locate(id);
+			}
+			else {
+				m_looseIds.insert(id);
+			}
+		}
+	}
+
+	/*
+	 * Rebuilds the hull from the current hull vertices, the loose points and the given extra points.
+	 */
+	void rebuild(const std::vector<size_t>& extraIds) {
+		std::vector<size_t> previousHullIds;
+		std::unordered_set<size_t> visitedIds;
+		if (m_hull.isFullDimensional()) {
+			for (const edgeptr& theEdge : hullgraph::exploreGraph(m_hull.vertex())) {
+				size_t id = theEdge->origin()->data().label;
+				if (m_records[id].alive && visitedIds.insert(id).second) {
+					previousHullIds.push_back(id);
+				}
+			}
+		}
+
+		std::vector<hull_point> candidates;
+		const std::vector<size_t>* idLists[] = { &previousHullIds, &extraIds };
+		for (const std::vector<size_t>* idList : idLists) {
+			for (size_t id : *idList) {
+				if (m_records[id].alive) {
+					candidates.push_back(makeHullPoint(id));
+				}
+			}
+		}
+
+		for (size_t id : m_looseIds) {
+			candidates.push_back(makeHullPoint(id));
+		}
+
+		bool wasFullDimensional = m_hull.isFullDimensional();
+		hullgraph::destroyGraph(m_hull.vertex());
+		m_hull = incremental_convex_hull<hull_point>();
+		m_hull.insert(candidates);
+		markHullVertices();
+
+		std::vector<size_t> unsettledIds = previousHullIds;
+		unsettledIds.insert(unsettledIds.end(), extraIds.begin(), extraIds.end());
+
+		if (wasFullDimensional && !m_hull.isFullDimensional()) {
+			// All the points are now coplanar, none of them can stay charged
+			for (size_t id = 0; id < m_records.size(); id++) {
+				if (m_records[id].alive && m_records[id].charged) {
+					uncharge(id);
+					unsettledIds.push_back(id);
+				}
+			}
+		}
+
+		std::vector<size_t> looseIds(m_looseIds.begin(), m_looseIds.end());
+		unsettledIds.insert(unsettledIds.end(), looseIds.begin(), looseIds.end());
+		settle(unsettledIds);
+	}
+
+public:
+	dynamic_convex_hull() = default;
+
+	/*
+	 * Destroys the graph of the hull, see destroyGraph.
+	 */
+	~dynamic_convex_hull() {
+		hullgraph::destroyGraph(m_hull.vertex());
+	}
+
+	/*
+	 * Adds a point and returns its id.
+	 */
+	template<class Point>
+	size_t insert(const Point& thePoint) {
+		size_t id = m_records.size();
+		point_record record;
+		record.coordinates = { thePoint.x, thePoint.y, thePoint.z };
+		record.alive = true;
+		record.charged = false;
+		m_records.push_back(record);
+		m_dependents.emplace_back();
+		m_size++;
+
+		if (m_hull.isFullDimensional() && locateAlongLine(id)) {
+			return id;
+		}
+
+		// The vertices the point adds to the hull come with the change, and the ones it removes
+		// are charged to the new hull
+		bool wasFullDimensional = m_hull.isFullDimensional();
+		std::vector<size_t> unsettledIds;
+		m_hull.insert(makeHullPoint(id), [&](convex_hull_update, const vertexptr&, const convex_hull_delta<hull_point>& delta) {
+			for (const vertexptr& createdVertex : delta.createdVertices) {
+				m_records[createdVertex->data().label].hullVertex = createdVertex;
+			}
+			for (const vertexptr& removedVertex : delta.removedVertices) {
+				unsettledIds.push_back(removedVertex->data().label);
+			}
+		});
+
+		unsettledIds.push_back(id);
+		if (!wasFullDimensional && m_hull.isFullDimensional()) {
+			markHullVertices();
+			unsettledIds.insert(unsettledIds.end(), m_looseIds.begin(), m_looseIds.end());
+		}
+
+		settle(unsettledIds);
+		return id;
+	}
+
+	/*
+	 * Removes the point with the given id. Returns false if there is no such point.
+	 */
+	bool erase(size_t pointId) {
+		if (pointId >= m_records.size() || !m_records[pointId].alive) {
+			return false;
+		}
+
+		point_record& record = m_records[pointId];
+		record.alive = false;
+		m_size--;
+
+		std::vector<size_t> orphanIds;
+		while (m_dependents[pointId].size()) {
+			orphanIds.push_back(m_dependents[pointId].back());
+			uncharge(orphanIds.back());
+		}
+
+		if (!m_hull.isFullDimensional()) {
+			m_looseIds.erase(pointId);
+			rebuild(orphanIds);
+		}
+		else if (isOnHull(pointId)) {
+			// Only the points charged to the vertex and the loose points can take its place
+			std::vector<hull_point> candidates;
+			for (size_t id : orphanIds) {
+				candidates.push_back(makeHullPoint(id));
+			}
+			for (size_t id : m_looseIds) {
+				candidates.push_back(makeHullPoint(id));
+			}
+
+			std::vector<vertexptr> newVertices;
+			if (m_hull.eraseVertex(record.hullVertex, candidates, newVertices)) {
+				record.hullVertex = nullptr;
+				for (const vertexptr& newVertex : newVertices) {
+					size_t id = newVertex->data().label;
+					m_records[id].hullVertex = newVertex;
+					m_looseIds.erase(id);
+				}
+
+				settle(orphanIds);
+			}
+			else {
+				rebuild(orphanIds);
+			}
+		}
+		else {
+			uncharge(pointId);
+			m_looseIds.erase(pointId);
+			settle(orphanIds);
+		}
+
+		return true;
+	}
+
+	/*
+	 * Returns a vertex of the current hull, with the same conventions as incremental_convex_hull.
+	 */
+	vertexptr vertex() const {
+		return m_hull.vertex();
+	}
+
+	/*
+	 * Returns whether a point with the given id is present.
+	 */
+	bool contains(size_t pointId) const {
+		return pointId < m_records.size() && m_records[pointId].alive;
+	}
+
+	/*
+	 * Returns the coordinates of the point with the given id.
+	 */
+	const point<F>& coordinates(size_t pointId) const {
+		return m_records[pointId].coordinates;
+	}
+
+	/*
+	 * Returns the number of points present.
+	 */
+	size_t size() const {
+		return m_size;
+	}
+};
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "hullgraph.h"
+#include "pointsource.h"
+#include "parallel.h"
+
+#include <array>
+#include <numeric>
+
+/*
+ * Computes twice the signed area of the triangle abc in the plane, positive if a, b and c are in
+ * counterclockwise order. Only the x and y members of the points are used.
+ */
+template<class Point2>
+decltype(Point2::x) orientation2D(const Point2& a, const Point2& b, const Point2& c) {
+	return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+/*
+ * Options for convexHull2DIndices.
+ */
+struct convex_hull_2d_options {
+	// Keep the points in the middle of the sides of the hull as its vertices
+	bool keepCollinear = false;
+
+	// How the passes over all points are run in parallel
+	execution_policy execution;
+};
+
+/*
+ * Computes the convex hull of points in the plane, which can come from any point source whose
+ * points have members x and y. Returns the indices of the hull vertices in counterclockwise order,
+ * starting from the smallest point by x and then y. Of equal points, only the one with the
+ * smallest index is used. If the points are collinear, only the two extremes are returned.
+ *
+ * Points inside the octagon of the extremes along the axes and the diagonals can't be hull
+ * vertices and are dropped in a first pass, then the rest are sorted and joined with Andrew's monotone chain.
+ * Both the first pass and the sort are split between threads for large inputs.
+ */
+template<class Source>
+std::vector<size_t> convexHull2DIndices(const Source& points, const convex_hull_2d_options& options = convex_hull_2d_options()) {
+	using F = decltype(point_source_element_t<Source>::x);
+
+	size_t n = points.size();
+
+	execution_policy blockExecution = options.execution.forItems(n);
+
+	auto lessXY = [&](size_t i, size_t j) {
+		const auto& p = points[i];
+		const auto& q = points[j];
+		return p.x < q.x || (p.x == q.x && (p.y < q.y || (p.y == q.y && i < j)));
+	};
+
+	std::vector<size_t> candidates;
+	if (n < 8) {
+		candidates.resize(n);
+		std::iota(candidates.begin(), candidates.end(), size_t(0));
+	}
+	else {
+		// The extreme points in eight directions, in counterclockwise order: left, lower left,
+		// down, lower right, right, upper right, up and upper left
+		const int directions[8][2] = { {-1, 0}, {-1, -1}, {0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1} };
+		auto score = [&](size_t i, size_t k) {
+			const auto& thePoint = points[i];
+			return F(directions[k][0]) * thePoint.x + F(directions[k][1]) * thePoint.y;
+		};
+
+		std::vector<std::array<size_t, 8>> blockExtremes(blockExecution.threadCount);
+		size_t blockCount = parallelBlocks(n, blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+			std::array<size_t, 8>& extremes = blockExtremes[blockIndex];
+			std::array<F, 8> bestScores;
+			for (size_t k = 0; k < 8; k++) {
+				extremes[k] = begin;
+				bestScores[k] = score(begin, k);
+			}
+
+			for (size_t i = begin + 1; i < end; i++) {
+				for (size_t k = 0; k < 8; k++) {
+					F pointScore = score(i, k);
+					if (bestScores[k] < pointScore) {
+						bestScores[k] = pointScore;
+						extremes[k] = i;
+					}
+				}
+			}
+		});
+
+		std::array<size_t, 8> extremes = blockExtremes[0];
+		for (size_t blockIndex = 1; blockIndex < blockCount; blockIndex++) {
+			for (size_t k = 0; k < 8; k++) {
+				if (score(extremes[k], k) < score(blockExtremes[blockIndex][k], k)) {
+					extremes[k] = blockExtremes[blockIndex][k];
+				}
+			}
+		}
+
+		// A point strictly inside of the octagon is strictly inside of the hull. Sides between
+		// equal extremes never have a point strictly on their inner side, so nothing is dropped
+		// when the octagon is degenerate.
+		std::vector<std::vector<size_t>> blockCandidates(blockCount);
+		parallelBlocks(n, blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				const auto& thePoint = points[i];
+				bool isInside = true;
+				for (size_t k = 0; k < 8 && isInside; k++) {
+					isInside = orientation2D(points[extremes[k]], points[extremes[(k + 1) % 8]], thePoint) > F(0);
+				}
+
+				if (!isInside) {
+					blockCandidates[blockIndex].push_back(i);
+				}
+			}
+		});
+
+		for (const std::vector<size_t>& block : blockCandidates) {
+			candidates.insert(candidates.end(), block.begin(), block.end());
+		}
+	}
+
+	parallelSort(candidates.begin(), candidates.end(), lessXY, blockExecution);
+	candidates.erase(std::unique(candidates.begin(), candidates.end(), [&](size_t i, size_t j) {
+		return points[i].x == points[j].x && points[i].y == points[j].y;
+	}), candidates.end());
+
+	if (candidates.size() <= 2) {
+		return candidates;
+	}
+
+	// With collinear points kept, collinear input would go around the line in both directions
+	if (options.keepCollinear) {
+		bool isCollinear = true;
+		for (size_t i = 1; i + 1 < candidates.size() && isCollinear; i++) {
+			isCollinear = orientation2D(points[candidates.front()], points[candidates.back()], points[candidates[i]]) == F(0);
+		}
+
+		if (isCollinear) {
+			return { candidates.front(), candidates.back() };
+		}
+	}
+
+	// The lower chain from left to right, then the upper chain back
+	std::vector<size_t> hullIndices;
+	for (int pass = 0; pass < 2; pass++) {
+		size_t chainStart = hullIndices.size();
+		for (size_t i : candidates) {
+			while (hullIndices.size() >= chainStart + 2) {
+				F turn = orientation2D(points[hullIndices[hullIndices.size() - 2]], points[hullIndices.back()], points[i]);
+				if (turn > F(0) || (turn == F(0) && options.keepCollinear)) {
+					break;
+				}
+				hullIndices.pop_back();
+			}
+			hullIndices.push_back(i);
+		}
+
+		// The last point of a chain is the first point of the other
+		hullIndices.pop_back();
+		std::reverse(candidates.begin(), candidates.end());
+	}
+
+	return hullIndices;
+}
+
+/*
+ * Computes the convex hull of points in the plane like convexHull2DIndices, and builds it as a
+ * polygon of the graph. Returns its inner face, or null if the points are collinear.
+ */
+template<class Source>
+std::shared_ptr<hullgraph::face<point_source_element_t<Source>>> convexHull2DPolygon(
+	const Source& points,
+	const convex_hull_2d_options& options = convex_hull_2d_options())
+{
+	std::vector<point_source_element_t<Source>> hullPoints;
+	for (size_t index : convexHull2DIndices(points, options)) {
+		hullPoints.push_back(points[index]);
+	}
+
+	return hullgraph::makePolygon(hullPoints);
+}
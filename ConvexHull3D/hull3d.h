@@ -1,23 +1,48 @@
 #pragma once
 
 #include "hullgraph.h"
+#include "hull2d.h"
 #include "point.h"
+#include "parallel.h"
+#include "pointsource.h"
+#include "dedup.h"
 
 #include <random>
 #include <chrono>
+#include <atomic>
 #include <unordered_map>
+#include <map>
 #include <algorithm>
 #include <numeric>
+#include <cmath>
+#include <type_traits>
+#include <optional>
+#include <tuple>
 
 template<class Point>
-decltype(Point::x) facePointOrientation(std::shared_ptr<hullgraph::face<Point>> theFace, const Point& thePoint) {
-	Point points[3];
+decltype(Point::x) facePointOrientation(const std::shared_ptr<hullgraph::face<Point>>& theFace, const Point& thePoint) {
+	// The vertices are only referenced, so labels aren't copied
 	auto walkingEdge = theFace->outerComponent();
-	points[0] = walkingEdge->origin()->data();
+	const Point& a = walkingEdge->origin()->data();
 	walkingEdge = walkingEdge->next();
-	points[1] = walkingEdge->origin()->data();
-	points[2] = walkingEdge->destination()->data();
-	return orientation(points[0], points[1], points[2], thePoint);
+	const Point& b = walkingEdge->origin()->data();
+	const Point& c = walkingEdge->destination()->data();
+	return orientation(a, b, c, thePoint);
+}
+
+/*
+ * Returns the signed distance of the point from the plane of the given face, positive on the
+ * outer side of the face.
+ */
+template<class Point>
+double facePointDistance(const std::shared_ptr<hullgraph::face<Point>>& theFace, const Point& thePoint) {
+	auto walkingEdge = theFace->outerComponent();
+	const Point& a = walkingEdge->origin()->data();
+	walkingEdge = walkingEdge->next();
+	const Point& b = walkingEdge->origin()->data();
+	const Point& c = walkingEdge->destination()->data();
+	auto normalVector = vectorProduct(b - a, c - a);
+	return double(orientation(a, b, c, thePoint)) / std::sqrt(double(scalarProduct(normalVector, normalVector)));
 }
 
 enum class convex_hull_update : char {
@@ -28,163 +53,1814 @@ enum class convex_hull_update : char {
 	afterRemoveRedundantVertices,
 };
 
-template<class Point, class Callback>
-std::shared_ptr<hullgraph::vertex<Point>> computeConvexHull3D(const std::vector<Point>& points, Callback callback) {
+/*
+ * Counts of the work done by computeConvexHull3D and incremental_convex_hull. They are only
+ * collected with the collectStatistics option, otherwise they stay zero.
+ */
+struct convex_hull_statistics {
+	size_t orientationTests = 0;
+	size_t conflictInserts = 0;
+	size_t conflictErases = 0;
+	size_t joinFacesCalls = 0;
+
+	// The total number of edges on the horizons of all joinFaces calls
+	size_t horizonLength = 0;
+
+	size_t facesCreated = 0;
+	size_t facesMerged = 0;
+	size_t redundantVerticesRemoved = 0;
+
+	// The largest number of points conflicting with a single face
+	size_t peakConflictListSize = 0;
+};
+
+/*
+ * The vertices, faces and half-edges created and removed since the previous update, for callbacks
+ * which keep their own copy of the hull. Objects created and removed between two updates aren't
+ * listed. Removed objects are already invalidated, but can still be used to look them up, and
+ * removed vertices still hold their points.
+ * With initialTetrahedron, the hull has been built from scratch, and the delta lists all of it.
+ */
+template<class Point>
+struct convex_hull_delta {
+	std::vector<std::shared_ptr<hullgraph::vertex<Point>>> createdVertices;
+	std::vector<std::shared_ptr<hullgraph::vertex<Point>>> removedVertices;
+	std::vector<std::shared_ptr<hullgraph::face<Point>>> createdFaces;
+	std::vector<std::shared_ptr<hullgraph::face<Point>>> removedFaces;
+	std::vector<std::shared_ptr<hullgraph::edge<Point>>> createdEdges;
+	std::vector<std::shared_ptr<hullgraph::edge<Point>>> removedEdges;
+};
+
+/*
+ * Options for computeConvexHull3D and incremental_convex_hull.
+ */
+struct convex_hull_options {
+	// Keep every face a triangle. Coplanar triangles aren't merged into a single face and the
+	// redundant vertex passes are skipped, except where needed to avoid zero-area triangles.
+	bool triangulate = false;
+
+	// Points closer than this to the plane of a face are treated as lying on it: they don't
+	// extend the hull, and each group of adjacent faces whose vertices lie within this distance
+	// of a common plane is merged into one face, so the faces are only planar up to the
+	// tolerance. Points added to such a hull are tested against the merged faces, and only the
+	// faces they create are merged again, with each other and with the faces around them, so
+	// the faces may differ slightly from those of the hull of all points at once. Zero means
+	// exact comparisons.
+	double coplanarityTolerance = 0;
+
+	// Build the initial tetrahedron from extreme points instead of the first four points which
+	// span the space, see findExtremeSimplex. Costs three more passes over the points, but on
+	// sorted or clustered input it leaves far fewer points outside of the first hull.
+	bool extremeInitialSimplex = false;
+
+	// Collapse equal points before they are added, see deduplicatePoints. Costs a sort of the
+	// points, but duplicates no longer go through the conflict graph.
+	bool removeDuplicates = false;
+
+	// Count the work done in the statistics of the hull, see convex_hull_statistics. Each count
+	// only adds a predictable branch when this is off. The overloads of computeConvexHull3D which
+	// return the statistics turn it on.
+	bool collectStatistics = false;
+
+	// How the passes over all points are run in parallel, see execution_policy
+	execution_policy execution;
+
+	// Stop adding points once the token is set or the deadline has passed. Both are checked before
+	// each point is added and every few points while the conflict graph is built, and the result
+	// is the hull of the points added so far, see isPartial.
+	const std::atomic<bool>* cancellationToken = nullptr;
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+/*
+ * Returns the indices of up to four points which span a large simplex: the lexicographically
+ * smallest and largest point, the point farthest from the line through them, and the point
+ * farthest from the plane through those three. Stops early if the points are all equal, collinear
+ * or coplanar. Each of the three passes is run in parallel as set by the execution policy.
+ */
+template<class Source>
+std::vector<size_t> findExtremeSimplex(const Source& points, const execution_policy& execution = execution_policy()) {
+	using Point = point_source_element_t<Source>;
+	using F = decltype(Point::x);
+
+	execution_policy blockExecution = execution.forItems(points.size());
+	size_t threadCount = blockExecution.threadCount;
+
+	// Returns the index with the largest score, or points.size() if no score is positive.
+	// Ties go to the smallest index, so that the result doesn't depend on the thread count.
+	auto findBest = [&](auto score) {
+		std::vector<size_t> blockBest(threadCount, points.size());
+		std::vector<F> blockScore(threadCount, F(0));
+		size_t blockCount = parallelBlocks(points.size(), blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				F value = score(points[i]);
+				if (value > blockScore[blockIndex]) {
+					blockScore[blockIndex] = value;
+					blockBest[blockIndex] = i;
+				}
+			}
+		});
+
+		size_t best = 0;
+		for (size_t blockIndex = 1; blockIndex < blockCount; blockIndex++) {
+			if (blockScore[blockIndex] > blockScore[best]) {
+				best = blockIndex;
+			}
+		}
+
+		return blockBest[best];
+	};
+
+	std::vector<size_t> simplex;
+	if (!points.size()) {
+		return simplex;
+	}
+
+	std::vector<size_t> blockLowest(threadCount), blockHighest(threadCount);
+	size_t blockCount = parallelBlocks(points.size(), blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+		size_t lowest = begin, highest = begin;
+		for (size_t i = begin + 1; i < end; i++) {
+			if (points[i] < points[lowest]) {
+				lowest = i;
+			}
+			if (points[highest] < points[i]) {
+				highest = i;
+			}
+		}
+
+		blockLowest[blockIndex] = lowest;
+		blockHighest[blockIndex] = highest;
+	});
+
+	size_t lowest = blockLowest[0], highest = blockHighest[0];
+	for (size_t blockIndex = 1; blockIndex < blockCount; blockIndex++) {
+		if (points[blockLowest[blockIndex]] < points[lowest]) {
+			lowest = blockLowest[blockIndex];
+		}
+		if (points[highest] < points[blockHighest[blockIndex]]) {
+			highest = blockHighest[blockIndex];
+		}
+	}
+
+	simplex.push_back(lowest);
+	if (points[lowest] == points[highest]) {
+		return simplex;
+	}
+
+	simplex.push_back(highest);
+	const Point& a = points[lowest];
+	auto lineVector = points[highest] - a;
+	size_t third = findBest([&](const Point& thePoint) {
+		auto normalVector = vectorProduct(lineVector, thePoint - a);
+		return scalarProduct(normalVector, normalVector);
+	});
+
+	if (third == points.size()) {
+		return simplex;
+	}
+
+	simplex.push_back(third);
+	const Point& b = points[highest];
+	const Point& c = points[third];
+	size_t fourth = findBest([&](const Point& thePoint) {
+		F orientationValue = orientation(a, b, c, thePoint);
+		return orientationValue < F(0) ? -orientationValue : orientationValue;
+	});
+
+	if (fourth != points.size()) {
+		simplex.push_back(fourth);
+	}
+
+	return simplex;
+}
+
+/*
+ * Splits a convex face into triangles, avoiding zero-area triangles when some of its vertices
+ * are collinear. Returns the list of resulting faces. The given face is one of them.
+ */
+template<class Point>
+std::vector<std::shared_ptr<hullgraph::face<Point>>> triangulateFace(const std::shared_ptr<hullgraph::face<Point>>& theFace) {
 	using namespace hullgraph;
+
+	std::vector<std::shared_ptr<face<Point>>> triangles;
+	auto remainingFace = theFace;
+
+	while (true) {
+		auto edges = faceToEdgeList(remainingFace);
+		size_t degree = edges.size();
+
+		if (degree <= 3) {
+			break;
+		}
+
+		// Find an ear at a vertex which isn't collinear with its neighbors, and whose clipping
+		// doesn't leave all the other vertices on a single line
+		bool found = false;
+		for (size_t i = 0; i < degree && !found; i++) {
+			size_t iPrev = i == 0 ? degree - 1 : i - 1;
+			size_t iNext = i == degree - 1 ? 0 : i + 1;
+			const Point& prevPoint = edges[iPrev]->origin()->data();
+			const Point& nextPoint = edges[iNext]->origin()->data();
+
+			if (collinear(prevPoint, edges[i]->origin()->data(), nextPoint)) {
+				continue;
+			}
+
+			bool leavesDegenerate = true;
+			for (size_t j = 0; j < degree && leavesDegenerate; j++) {
+				if (j != i && !collinear(prevPoint, nextPoint, edges[j]->origin()->data())) {
+					leavesDegenerate = false;
+				}
+			}
+
+			if (!leavesDegenerate) {
+				auto diagonal = splitFace(edges[iPrev], edges[iNext]);
+				triangles.push_back(diagonal->incidentFace());
+				remainingFace = diagonal->twin()->incidentFace();
+				found = true;
+			}
+		}
+
+		if (!found) {
+			break;
+		}
+	}
+
+	triangles.push_back(remainingFace);
+	return triangles;
+}
+
+/*
+ * The points of a source projected onto a coordinate plane, by leaving out the coordinate on the
+ * given axis and keeping the other two in cyclic order, so that orientations in the projection are
+ * the same as seen from the positive side of the axis.
+ */
+template<class Source>
+struct axis_projected_point_source {
+	using F = decltype(point_source_element_t<Source>::x);
+
+	const Source& points;
+	int axis;
+
+	size_t size() const {
+		return points.size();
+	}
+
+	point<F> operator[](size_t index) const {
+		const auto& thePoint = points[index];
+		if (axis == 0) {
+			return { thePoint.y, thePoint.z, F(0) };
+		}
+		if (axis == 1) {
+			return { thePoint.z, thePoint.x, F(0) };
+		}
+		return { thePoint.x, thePoint.y, F(0) };
+	}
+};
+
+/*
+ * Computes the convex hull of a set of coplanar points, given a nonzero normal vector of their plane.
+ * Returns the hull points in counterclockwise order as seen from the direction of the normal vector,
+ * starting from the smallest point, including points in the middle of the polygon sides. The points
+ * can come from any point source. The points are projected onto the coordinate plane the normal
+ * vector is closest to being perpendicular to, and their hull is computed by convexHull2DIndices.
+ */
+template<class Source>
+std::vector<point_source_element_t<Source>> planarConvexHull(
+	const Source& points,
+	const point<decltype(point_source_element_t<Source>::x)>& normalVector,
+	const execution_policy& execution = execution_policy())
+{
+	using Point = point_source_element_t<Source>;
+	using F = decltype(Point::x);
+
+	F normalComponents[3] = { normalVector.x, normalVector.y, normalVector.z };
+	auto magnitude = [](F value) {
+		return value < F(0) ? -value : value;
+	};
+
+	int axis = 0;
+	for (int k = 1; k < 3; k++) {
+		if (magnitude(normalComponents[axis]) < magnitude(normalComponents[k])) {
+			axis = k;
+		}
+	}
+
+	convex_hull_2d_options options;
+	options.keepCollinear = true;
+	options.execution = execution;
+	std::vector<size_t> hullIndices = convexHull2DIndices(axis_projected_point_source<Source>{ points, axis }, options);
+
+	// The projection is seen from the other side if the normal vector points away from the axis
+	if (normalComponents[axis] < F(0)) {
+		std::reverse(hullIndices.begin(), hullIndices.end());
+	}
+
+	std::vector<Point> hullPoints(hullIndices.size());
+	for (size_t i = 0; i < hullIndices.size(); i++) {
+		hullPoints[i] = points[hullIndices[i]];
+	}
+
+	std::rotate(hullPoints.begin(), std::min_element(hullPoints.begin(), hullPoints.end()), hullPoints.end());
+	return hullPoints;
+}
+
+/*
+ * Finds the faces of a full-dimensional hull a point is outside of without testing it against all
+ * of them, for adding points to a hull which already has many faces. Each face is represented by
+ * its normal divided by how far its plane is from a point inside of the hull, so that a point is
+ * outside of the face exactly when the scalar product of this scaled normal and the point, taken
+ * relative to the inner point, is greater than one. The scaled normals are the vertices of a
+ * convex polytope whose edges join neighboring faces, so the face with the greatest product is
+ * reached by walking to better neighbors from any face, and the point is outside of the hull
+ * exactly when that product is greater than one. The faces the point is outside of are then
+ * found around that face, as they are connected. The walk is done in floating point, and points
+ * it can't tell apart from the boundary are tested against all faces. No two faces should be
+ * coplanar, which only triangulated hulls allow.
+ */
+template<class Point>
+class hull_face_locator {
+	using faceptr = std::shared_ptr<hullgraph::face<Point>>;
+
+	// Points whose greatest product is within this of one are tested against all faces
+	static constexpr double margin = 1e-6;
+
+	const std::vector<faceptr>& m_faces;
+	point<double> m_center = { 0, 0, 0 };
+	std::vector<point<double>> m_scaledNormals;
+
+	// The neighbors of face i are m_neighbors[m_neighborOffsets[i]] to m_neighbors[m_neighborOffsets[i + 1] - 1]
+	std::vector<size_t> m_neighborOffsets;
+	std::vector<size_t> m_neighbors;
+	bool m_isUsable = true;
+
+	static point<double> toDouble(const Point& thePoint) {
+		return { double(thePoint.x), double(thePoint.y), double(thePoint.z) };
+	}
+
+public:
+	/*
+	 * The scratch space of one thread locating points.
+	 */
+	struct scratch {
+		std::vector<size_t> marks;
+		std::vector<size_t> stack;
+		size_t stamp = 0;
+		size_t startFace = 0;
+		size_t orientationTests = 0;
+	};
+
+	/*
+	 * Sets up the locator for the given faces, which should be all faces of the hull and outlive the locator.
+	 */
+	hull_face_locator(const std::vector<faceptr>& faces) : m_faces(faces) {
+		using namespace hullgraph;
+
+		std::unordered_map<faceptr, size_t> faceIndices;
+		size_t edgeCount = 0;
+		for (size_t i = 0; i < faces.size(); i++) {
+			faceIndices.emplace(faces[i], i);
+			for (const auto& faceEdge : faceToEdgeList(faces[i])) {
+				point<double> origin = toDouble(faceEdge->origin()->data());
+				m_center = { m_center.x + origin.x, m_center.y + origin.y, m_center.z + origin.z };
+				edgeCount++;
+			}
+		}
+
+		// Every vertex is counted once for each of its edges, which still gives a point strictly inside
+		m_center = { m_center.x / double(edgeCount), m_center.y / double(edgeCount), m_center.z / double(edgeCount) };
+
+		m_neighborOffsets.push_back(0);
+		for (const faceptr& theFace : faces) {
+			auto walkingEdge = theFace->outerComponent();
+			point<double> a = toDouble(walkingEdge->origin()->data());
+			point<double> b = toDouble(walkingEdge->next()->origin()->data());
+			point<double> c = toDouble(walkingEdge->next()->destination()->data());
+			point<double> normal = vectorProduct(b - a, c - a);
+			double reach = scalarProduct(normal, a - m_center);
+			if (!(reach > 0)) {
+				m_isUsable = false;
+				return;
+			}
+
+			m_scaledNormals.push_back({ normal.x / reach, normal.y / reach, normal.z / reach });
+			for (const auto& faceEdge : faceToEdgeList(theFace)) {
+				m_neighbors.push_back(faceIndices.at(faceEdge->twin()->incidentFace()));
+			}
+			m_neighborOffsets.push_back(m_neighbors.size());
+		}
+	}
+
+	/*
+	 * Returns false if the hull is too thin for the floating point walk, in which case the points
+	 * should be tested against all faces.
+	 */
+	bool isUsable() const {
+		return m_isUsable;
+	}
+
+	/*
+	 * Calls visit with the index of each face the point is outside of, as told by isOutside.
+	 * Walks from the face the previous point of the same scratch space ended on.
+	 */
+	template<class IsOutside, class Visit>
+	void locate(const Point& thePoint, scratch& space, const IsOutside& isOutside, const Visit& visit) const {
+		point<double> offset = toDouble(thePoint) - m_center;
+		size_t current = space.startFace;
+		double value = scalarProduct(m_scaledNormals[current], offset);
+		for (size_t previous = m_faces.size(); previous != current;) {
+			previous = current;
+			for (size_t k = m_neighborOffsets[previous]; k < m_neighborOffsets[previous + 1]; k++) {
+				double neighborValue = scalarProduct(m_scaledNormals[m_neighbors[k]], offset);
+				if (neighborValue > value) {
+					current = m_neighbors[k];
+					value = neighborValue;
+				}
+			}
+		}
+		space.startFace = current;
+
+		space.orientationTests++;
+		if (isOutside(m_faces[current], thePoint)) {
+			if (space.marks.size() < m_faces.size()) {
+				space.marks.assign(m_faces.size(), 0);
+			}
+
+			space.stamp++;
+			space.marks[current] = space.stamp;
+			space.stack.push_back(current);
+			while (!space.stack.empty()) {
+				size_t visibleFace = space.stack.back();
+				space.stack.pop_back();
+				visit(visibleFace);
+				for (size_t k = m_neighborOffsets[visibleFace]; k < m_neighborOffsets[visibleFace + 1]; k++) {
+					size_t neighbor = m_neighbors[k];
+					if (space.marks[neighbor] != space.stamp) {
+						space.marks[neighbor] = space.stamp;
+						space.orientationTests++;
+						if (isOutside(m_faces[neighbor], thePoint)) {
+							space.stack.push_back(neighbor);
+						}
+					}
+				}
+			}
+		}
+		else if (value > 1 - margin) {
+			space.orientationTests += m_faces.size();
+			for (size_t i = 0; i < m_faces.size(); i++) {
+				if (isOutside(m_faces[i], thePoint)) {
+					visit(i);
+				}
+			}
+		}
+	}
+};
+
+template<class Point>
+class incremental_convex_hull;
+
+/*
+ * The scratch containers of the hull engine: the conflict graph, the order of the points and the
+ * vectors used by each step. A workspace passed to computeConvexHull3D or incremental_convex_hull
+ * keeps them between computations, so that computing many small hulls in a row reuses their
+ * memory instead of allocating it again for every hull. It also has a hullgraph::object_pool,
+ * which the vertices, edges and faces of the hulls come from, and which gets their memory back
+ * once the caller destroys a hull (see destroyGraph). With the default options, computing a hull
+ * of no more points than an earlier one then doesn't allocate at all. The pool is freed with the
+ * workspace and the last hull computed with it.
+ * A workspace can only be used by one computation at a time, and it also holds the random engine
+ * which shuffles the points, so computations with different workspaces share no mutable state
+ * and can run on different threads.
+ */
+template<class Point>
+class hull_workspace {
+	using vertexptr = std::shared_ptr<hullgraph::vertex<Point>>;
+	using edgeptr = std::shared_ptr<hullgraph::edge<Point>>;
+	using faceptr = std::shared_ptr<hullgraph::face<Point>>;
+
+	template<class Key>
+	using pooled_set = std::unordered_set<Key, std::hash<Key>, std::equal_to<Key>, hullgraph::pool_allocator<Key>>;
+
+	using conflict_map = std::unordered_map<faceptr, std::vector<size_t>, std::hash<faceptr>, std::equal_to<faceptr>,
+		hullgraph::pool_allocator<std::pair<const faceptr, std::vector<size_t>>>>;
+
+	// Null in the workspace a hull makes for itself, which doesn't outlive the hull
+	std::shared_ptr<hullgraph::object_pool> m_pool;
+
+	std::vector<Point> m_firstFourPoints;
+	std::vector<size_t> m_remainingIndices;
+	std::vector<pooled_set<faceptr>> m_pointToFaces;
+	conflict_map m_faceToPoints;
+	std::vector<std::vector<size_t>> m_spareLists;
+	std::vector<std::vector<std::vector<size_t>>> m_blockConflicts;
+	std::vector<typename hull_face_locator<Point>::scratch> m_blockScratch;
+
+	std::vector<faceptr> m_faces;
+	std::vector<faceptr> m_allFaces;
+	pooled_set<faceptr> m_allFaceSet;
+
+	// Only ever holds the faces around one point. Clearing a set takes time for each of its
+	// buckets, so it is kept apart from the sets which hold the whole hull.
+	pooled_set<faceptr> m_faceSet;
+	std::vector<edgeptr> m_faceEdges;
+	hullgraph::join_faces_result<Point> m_joinResult;
+	std::vector<edgeptr> m_newVertexEdges;
+	std::vector<vertexptr> m_borderVertices;
+	std::vector<bool> m_shouldMerge;
+	std::vector<bool> m_shouldSkip;
+	std::vector<faceptr> m_mergedFaces;
+	std::vector<size_t> m_newConflicts;
+
+	std::mt19937_64 m_rngEngine;
+
+	explicit hull_workspace(std::shared_ptr<hullgraph::object_pool> pool) :
+		m_pool(std::move(pool)),
+		m_faceToPoints(hullgraph::pool_allocator<typename conflict_map::value_type>(m_pool)),
+		m_allFaceSet(hullgraph::pool_allocator<faceptr>(m_pool)),
+		m_faceSet(hullgraph::pool_allocator<faceptr>(m_pool)),
+		m_rngEngine(std::chrono::high_resolution_clock::now().time_since_epoch().count()) {}
+
+	/*
+	 * Makes sure that there is a face set for each of the given number of points.
+	 */
+	void reservePoints(size_t pointCount) {
+		while (m_pointToFaces.size() < pointCount) {
+			m_pointToFaces.emplace_back(hullgraph::pool_allocator<faceptr>(m_pool));
+		}
+	}
+
+	/*
+	 * Returns an empty conflict list, reusing the memory of one given back earlier if possible.
+	 */
+	std::vector<size_t> takeList() {
+		if (m_spareLists.empty()) {
+			return {};
+		}
+
+		std::vector<size_t> list = std::move(m_spareLists.back());
+		m_spareLists.pop_back();
+		return list;
+	}
+
+	void giveList(std::vector<size_t>& list) {
+		list.clear();
+		m_spareLists.push_back(std::move(list));
+	}
+
+	/*
+	 * Empties all containers, without freeing their memory, after a computation over pointCount points.
+	 * The pointers to graph objects are dropped, so that they don't keep a destroyed hull alive.
+	 */
+	void clear(size_t pointCount) {
+		for (size_t i = 0; i < pointCount; i++) {
+			m_pointToFaces[i].clear();
+		}
+
+		for (auto& entry : m_faceToPoints) {
+			giveList(entry.second);
+		}
+
+		m_faceToPoints.clear();
+		m_remainingIndices.clear();
+		m_faces.clear();
+		m_allFaces.clear();
+		m_allFaceSet.clear();
+		m_faceSet.clear();
+		m_faceEdges.clear();
+		m_joinResult.removedVertices.clear();
+		m_joinResult.removedEdges.clear();
+		m_joinResult.borderEdges.clear();
+		m_joinResult.borderFaces.clear();
+		m_joinResult.newFace = nullptr;
+		m_newVertexEdges.clear();
+		m_borderVertices.clear();
+		m_mergedFaces.clear();
+		m_newConflicts.clear();
+	}
+
+	friend class incremental_convex_hull<Point>;
+
+public:
+	hull_workspace() : hull_workspace(std::make_shared<hullgraph::object_pool>()) {}
+};
+
+/*
+ * A convex hull which keeps its state between insertions. Points can be added one at a time
+ * or in batches. Each batch is checked against the faces of the current hull, points inside
+ * the hull are dropped right away and the rest are added with the same joinFaces/inscribeVertex
+ * steps used by computeConvexHull3D. The points of small batches are located by walking over
+ * the graph from the last added vertex, so a single point costs about the size of the part of
+ * the hull it changes rather than the size of the whole hull.
+ * While the points seen so far don't span the space, only the vertices of their planar hull
+ * (or the two extremes of their line) are retained.
+ */
+template<class Point>
+class incremental_convex_hull {
 	using F = decltype(Point::x);
-	using vertexptr = std::shared_ptr<vertex<Point>>;
-	using edgeptr = std::shared_ptr<edge<Point>>;
-	using faceptr = std::shared_ptr<face<Point>>;
+	using vertexptr = std::shared_ptr<hullgraph::vertex<Point>>;
+	using edgeptr = std::shared_ptr<hullgraph::edge<Point>>;
+	using faceptr = std::shared_ptr<hullgraph::face<Point>>;
+
+	convex_hull_options m_options;
+	std::unique_ptr<hull_workspace<Point>> m_ownWorkspace;
+	hull_workspace<Point>* m_workspace = nullptr;
+	std::vector<Point> m_degeneratePoints;
+	vertexptr m_peakVertex;
+	vertexptr m_planarVertex;
+
+	// A point strictly inside of the hull while it's full-dimensional. The hull only grows,
+	// so it stays inside until the hull is built again, or eraseVertex moves it.
+	point<double> m_innerPoint = { 0, 0, 0 };
+	mutable convex_hull_statistics m_statistics;
+	bool m_isPartial = false;
+
+	// The faces created since the nearly coplanar faces were last merged, with the tolerance
+	std::vector<faceptr> m_unmergedFaces;
+
+	hull_workspace<Point>& currentWorkspace() {
+		if (!m_workspace) {
+			m_ownWorkspace.reset(new hull_workspace<Point>(nullptr));
+			m_workspace = m_ownWorkspace.get();
+		}
+
+		return *m_workspace;
+	}
+
+	/*
+	 * Adds to one of the statistics counters, or does nothing if they aren't collected.
+	 */
+	void count(size_t convex_hull_statistics::* counter, size_t amount = 1) const {
+		if (m_options.collectStatistics) {
+			m_statistics.*counter += amount;
+		}
+	}
+
+	void countConflictList(size_t listSize) const {
+		if (m_options.collectStatistics) {
+			m_statistics.peakConflictListSize = std::max(m_statistics.peakConflictListSize, listSize);
+		}
+	}
+
+	// The changes since the last update, only collected for callbacks which take them
+	bool m_trackDelta = false;
+	std::unordered_set<vertexptr> m_createdVertices;
+	std::unordered_set<faceptr> m_createdFaces;
+	std::unordered_set<edgeptr> m_createdEdges;
+	std::vector<vertexptr> m_removedVertices;
+	std::vector<faceptr> m_removedFaces;
+	std::vector<edgeptr> m_removedEdges;
+
+	template<class Callback>
+	static constexpr bool takesDelta = std::is_invocable_v<Callback&, convex_hull_update, const vertexptr&, const convex_hull_delta<Point>&> ||
+		std::is_invocable_v<Callback&, convex_hull_update, const vertexptr&, const convex_hull_delta<Point>&, const convex_hull_statistics&>;
+
+	/*
+	 * The faces an operation on the graph is about to change, with their edges and vertices.
+	 */
+	struct graph_snapshot {
+		std::vector<faceptr> faces;
+		std::unordered_set<edgeptr> edges;
+		std::unordered_set<vertexptr> vertices;
+	};
+
+	/*
+	 * Takes a snapshot of the given faces before they are changed, if the changes are tracked.
+	 */
+	graph_snapshot beginChange(const std::vector<faceptr>& faces) const {
+		graph_snapshot snapshot;
+		if (m_trackDelta) {
+			snapshot.faces = faces;
+			for (const faceptr& theFace : faces) {
+				for (const edgeptr& faceEdge : hullgraph::faceToEdgeList(theFace)) {
+					snapshot.edges.insert(faceEdge);
+					snapshot.vertices.insert(faceEdge->origin());
+				}
+			}
+		}
+
+		return snapshot;
+	}
+
+	graph_snapshot beginChange(std::initializer_list<faceptr> faces) const {
+		return m_trackDelta ? beginChange(std::vector<faceptr>(faces)) : graph_snapshot();
+	}
+
+	/*
+	 * Records the changes made by an operation, given the snapshot taken before it and the faces
+	 * covering the changed part of the graph after it. Objects from the snapshot which were
+	 * invalidated are removed, and the objects of the given faces which aren't in the snapshot
+	 * are created.
+	 */
+	void endChange(const graph_snapshot& snapshot, const std::vector<faceptr>& facesAfter) {
+		if (!m_trackDelta) {
+			return;
+		}
+
+		for (const faceptr& theFace : snapshot.faces) {
+			if (!theFace->outerComponent() && !m_createdFaces.erase(theFace)) {
+				m_removedFaces.push_back(theFace);
+			}
+		}
+		for (const edgeptr& theEdge : snapshot.edges) {
+			if (!theEdge->origin() && !m_createdEdges.erase(theEdge)) {
+				m_removedEdges.push_back(theEdge);
+			}
+		}
+		for (const vertexptr& theVertex : snapshot.vertices) {
+			if (!theVertex->incidentEdge() && !m_createdVertices.erase(theVertex)) {
+				m_removedVertices.push_back(theVertex);
+			}
+		}
+
+		for (const faceptr& theFace : facesAfter) {
+			if (std::find(snapshot.faces.begin(), snapshot.faces.end(), theFace) == snapshot.faces.end()) {
+				m_createdFaces.insert(theFace);
+			}
+
+			for (const edgeptr& faceEdge : hullgraph::faceToEdgeList(theFace)) {
+				if (!snapshot.edges.count(faceEdge)) {
+					m_createdEdges.insert(faceEdge);
+				}
+				if (!snapshot.vertices.count(faceEdge->origin())) {
+					m_createdVertices.insert(faceEdge->origin());
+				}
+			}
+		}
+	}
+
+	void endChange(const graph_snapshot& snapshot, std::initializer_list<faceptr> facesAfter) {
+		if (m_trackDelta) {
+			endChange(snapshot, std::vector<faceptr>(facesAfter));
+		}
+	}
+
+	faceptr removeEdgeTracked(const edgeptr& theEdge) {
+		graph_snapshot snapshot = beginChange({ theEdge->incidentFace(), theEdge->twin()->incidentFace() });
+		faceptr mergedFace = hullgraph::removeEdge(theEdge);
+		endChange(snapshot, { mergedFace });
+		return mergedFace;
+	}
+
+	edgeptr removeRedundantVertexTracked(const vertexptr& theVertex) {
+		edgeptr outEdge = theVertex->incidentEdge();
+		graph_snapshot snapshot = beginChange({ outEdge->incidentFace(), outEdge->twin()->incidentFace() });
+		edgeptr bridgeEdge = hullgraph::removeRedundantVertex(theVertex);
+		if (bridgeEdge) {
+			endChange(snapshot, { bridgeEdge->incidentFace(), bridgeEdge->twin()->incidentFace() });
+		}
+
+		return bridgeEdge;
+	}
+
+	/*
+	 * Invokes the callback, with the changes since the last update and the current statistics
+	 * if it takes them as additional arguments.
+	 */
+	template<class Callback>
+	void notify(Callback& callback, convex_hull_update update) {
+		convex_hull_delta<Point> delta;
+		if (m_trackDelta) {
+			delta.createdVertices.assign(m_createdVertices.begin(), m_createdVertices.end());
+			delta.createdFaces.assign(m_createdFaces.begin(), m_createdFaces.end());
+			delta.createdEdges.assign(m_createdEdges.begin(), m_createdEdges.end());
+			delta.removedVertices.swap(m_removedVertices);
+			delta.removedFaces.swap(m_removedFaces);
+			delta.removedEdges.swap(m_removedEdges);
+			m_createdVertices.clear();
+			m_createdFaces.clear();
+			m_createdEdges.clear();
+		}
+
+		if constexpr (std::is_invocable_v<Callback&, convex_hull_update, const vertexptr&, const convex_hull_delta<Point>&, const convex_hull_statistics&>) {
+			callback(update, m_peakVertex, delta, m_statistics);
+		}
+		else if constexpr (std::is_invocable_v<Callback&, convex_hull_update, const vertexptr&, const convex_hull_delta<Point>&>) {
+			callback(update, m_peakVertex, delta);
+		}
+		else if constexpr (std::is_invocable_v<Callback&, convex_hull_update, const vertexptr&, const convex_hull_statistics&>) {
+			callback(update, m_peakVertex, m_statistics);
+		}
+		else {
+			callback(update, m_peakVertex);
+		}
+	}
+
+	/*
+	 * The points retained from earlier insertions followed by the added ones, as a single point source.
+	 */
+	template<class Source>
+	struct joined_points {
+		const std::vector<Point>& retained;
+		const Source& added;
+
+		size_t size() const {
+			return retained.size() + added.size();
+		}
+
+		// Sources of references to Point are read without copying
+		using reference = std::conditional_t<std::is_same_v<decltype(std::declval<const Source&>()[size_t(0)]), const Point&>, const Point&, Point>;
+
+		reference operator[](size_t index) const {
+			if (index < retained.size()) {
+				return retained[index];
+			}
+
+			return added[index - retained.size()];
+		}
+	};
+
+	template<class Source, class Callback>
+	void insertPoints(const Source& points, Callback& callback);
+
+	/*
+	 * Inserts the points, or only their distinct points if duplicates are removed.
+	 */
+	template<class Source, class Callback>
+	void insertSource(const Source& points, Callback& callback) {
+		// The new objects of the graph come from the pool of the workspace, if it has one
+		hullgraph::pool_scope poolScope(currentWorkspace().m_pool);
+		if (m_options.removeDuplicates) {
+			deduplicated_points distinctPoints = deduplicatePoints(points, m_options.execution);
+			insertPoints(indexed_point_source<Source>{ points, distinctPoints.representatives }, callback);
+		}
+		else {
+			insertPoints(points, callback);
+		}
+	}
+
+	template<class Source, class Callback>
+	void insertDegenerate(const Source& addedPoints, Callback& callback);
+
+	template<class Source, class Callback>
+	void insertOutsidePoints(const Source& points, std::vector<size_t>& remainingIndices, Callback& callback);
+
+	template<class Callback>
+	void mergeNearlyCoplanarFaces(Callback& callback);
+
+	/*
+	 * Returns whether the cancellation token is set or the deadline has passed.
+	 */
+	bool shouldStop() const {
+		if (m_options.cancellationToken && m_options.cancellationToken->load(std::memory_order_relaxed)) {
+			return true;
+		}
+
+		return m_options.deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= m_options.deadline;
+	}
+
+	/*
+	 * Returns whether the point lies outside of the face, farther than the tolerance from it.
+	 */
+	bool isOutside(const faceptr& theFace, const Point& thePoint) const {
+		count(&convex_hull_statistics::orientationTests);
+		return isOutsideUncounted(theFace, thePoint);
+	}
+
+	/*
+	 * Same as isOutside, without touching the statistics, so that it can be called from several threads.
+	 */
+	bool isOutsideUncounted(const faceptr& theFace, const Point& thePoint) const {
+		if (m_options.coplanarityTolerance > 0) {
+			return facePointDistance(theFace, thePoint) > m_options.coplanarityTolerance;
+		}
+
+		return facePointOrientation(theFace, thePoint) > F(0);
+	}
+
+	static point<double> toDouble(const Point& thePoint) {
+		return { double(thePoint.x), double(thePoint.y), double(thePoint.z) };
+	}
+
+	static point<double> averagePoint(const std::vector<Point>& points) {
+		point<double> sum = { 0, 0, 0 };
+		for (const Point& thePoint : points) {
+			sum = { sum.x + double(thePoint.x), sum.y + double(thePoint.y), sum.z + double(thePoint.z) };
+		}
+
+		return { sum.x / double(points.size()), sum.y / double(points.size()), sum.z / double(points.size()) };
+	}
+
+	bool locateByWalking(const Point& thePoint, std::vector<faceptr>& visibleFaces);
+
+	void collectFaces(std::vector<faceptr>& faces);
+
+public:
+	incremental_convex_hull(const convex_hull_options& options = convex_hull_options()) : m_options(options) {}
+
+	/*
+	 * Uses the scratch containers of the given workspace, which should outlive the hull, instead of its own.
+	 */
+	incremental_convex_hull(const convex_hull_options& options, hull_workspace<Point>& workspace) : m_options(options), m_workspace(&workspace) {}
+
+	/*
+	 * Continues from the graph of a hull computed with the same options, such as a result of
+	 * computeConvexHull3D, which the new hull takes over. The graph of collinear points is null,
+	 * and gives an empty hull.
+	 */
+	incremental_convex_hull(const convex_hull_options& options, const vertexptr& hullVertex) : m_options(options) {
+		if (!hullVertex) {
+			return;
+		}
+
+		std::unordered_set<vertexptr> visitedVertices;
+		for (const edgeptr& theEdge : hullgraph::exploreGraph(hullVertex)) {
+			if (visitedVertices.insert(theEdge->origin()).second) {
+				m_degeneratePoints.push_back(theEdge->origin()->data());
+			}
+		}
+
+		// The graph is a polyhedron unless all of its vertices lie on the plane of a polygon
+		const std::vector<Point>& hullPoints = m_degeneratePoints;
+		size_t second = 1;
+		while (second < hullPoints.size() && hullPoints[second] == hullPoints[0]) {
+			second++;
+		}
+		size_t third = second + 1;
+		while (third < hullPoints.size() && collinear(hullPoints[0], hullPoints[second], hullPoints[third])) {
+			third++;
+		}
+
+		bool isFlat = true;
+		for (size_t i = third + 1; i < hullPoints.size() && isFlat; i++) {
+			isFlat = orientation(hullPoints[0], hullPoints[second], hullPoints[third], hullPoints[i]) == F(0);
+		}
+
+		if (isFlat) {
+			m_planarVertex = hullVertex;
+		}
+		else {
+			// The average of the vertices of a polyhedron is strictly inside of it
+			m_innerPoint = averagePoint(hullPoints);
+
+			m_peakVertex = hullVertex;
+			m_degeneratePoints.clear();
+		}
+	}
+
+	/*
+	 * Adds a single point to the hull.
+	 */
+	template<class Callback>
+	void insert(const Point& thePoint, Callback callback) {
+		insert(std::vector<Point>{ thePoint }, callback);
+	}
+
+	void insert(const Point& thePoint) {
+		insert(thePoint, [](convex_hull_update, const vertexptr&) {});
+	}
+
+	/*
+	 * Adds all points of the given range to the hull. The callback is invoked with the same
+	 * updates as the one given to computeConvexHull3D. Point sources of Point, see pointsource.h,
+	 * are read in place, other ranges are copied first.
+	 */
+	template<class Range, class Callback>
+	void insert(const Range& range, Callback callback) {
+		if constexpr (is_point_source_v<Range> && std::is_same_v<point_source_element_t<Range>, Point>) {
+			insertSource(range, callback);
+		}
+		else {
+			insertSource(std::vector<Point>(std::begin(range), std::end(range)), callback);
+		}
+	}
+
+	template<class Range>
+	void insert(const Range& range) {
+		insert(range, [](convex_hull_update, const vertexptr&) {});
+	}
+
+	/*
+	 * Adds all points of the given vector to the hull.
+	 */
+	template<class Callback>
+	void insert(std::vector<Point>&& points, Callback callback) {
+		insertSource(points, callback);
+	}
+
+	void insert(std::vector<Point>&& points) {
+		insert(std::move(points), [](convex_hull_update, const vertexptr&) {});
+	}
+
+	bool eraseVertex(const vertexptr& theVertex, const std::vector<Point>& candidates, std::vector<vertexptr>& newVertices);
+
+	/*
+	 * Returns a vertex of the current hull. If all points inserted so far are coplanar, returns a
+	 * vertex of their planar hull, and if they are collinear, returns null.
+	 */
+	vertexptr vertex() const {
+		return m_peakVertex ? m_peakVertex : m_planarVertex;
+	}
+
+	/*
+	 * Returns the vertices of the current hull. While the inserted points don't span the space,
+	 * these are the vertices of their planar hull, or the extremes of their line.
+	 */
+	std::vector<Point> vertices() const {
+		if (!m_peakVertex) {
+			return m_degeneratePoints;
+		}
+
+		std::vector<Point> hullVertices;
+		std::unordered_set<vertexptr> visitedVertices;
+		for (const edgeptr& theEdge : hullgraph::exploreGraph(m_peakVertex)) {
+			if (visitedVertices.insert(theEdge->origin()).second) {
+				hullVertices.push_back(theEdge->origin()->data());
+			}
+		}
+
+		return hullVertices;
+	}
+
+	/*
+	 * Returns whether the inserted points span the space, i.e. whether the hull is a polyhedron.
+	 */
+	bool isFullDimensional() const {
+		return !!m_peakVertex;
+	}
+
+	/*
+	 * Returns whether an insertion was stopped by the cancellation token or the deadline of the
+	 * options. The hull is still valid, but some of the inserted points may be outside of it.
+	 */
+	bool isPartial() const {
+		return m_isPartial;
+	}
+
+	/*
+	 * Returns the work done by all insertions so far, see convex_hull_statistics.
+	 */
+	const convex_hull_statistics& statistics() const {
+		return m_statistics;
+	}
+};
+
+template<class Point>
+template<class Source, class Callback>
+void incremental_convex_hull<Point>::insertPoints(const Source& points, Callback& callback) {
+	m_trackDelta = takesDelta<Callback>;
+	if (!m_peakVertex) {
+		insertDegenerate(points, callback);
+	}
+	else {
+		std::vector<size_t>& remainingIndices = currentWorkspace().m_remainingIndices;
+		remainingIndices.resize(points.size());
+		std::iota(remainingIndices.begin(), remainingIndices.end(), size_t(0));
+		insertOutsidePoints(points, remainingIndices, callback);
+	}
+}
+
+template<class Point>
+template<class Source, class Callback>
+void incremental_convex_hull<Point>::insertDegenerate(const Source& addedPoints, Callback& callback) {
+	using namespace hullgraph;
+
+	// The points retained from earlier insertions go first, they are replaced below
+	std::vector<Point> retainedPoints;
+	retainedPoints.swap(m_degeneratePoints);
+	joined_points<Source> points = { retainedPoints, addedPoints };
+
+	// With a tolerance, points closer than it to the point, line or plane spanned by the points
+	// picked so far aren't picked either, so that the initial tetrahedron is well shaped
+	double tolerance = m_options.coplanarityTolerance;
+	auto squaredLength = [](const point<F>& theVector) {
+		return double(scalarProduct(theVector, theVector));
+	};
+
+	std::vector<Point>& firstFourPoints = currentWorkspace().m_firstFourPoints;
+	std::vector<size_t>& remainingIndices = currentWorkspace().m_remainingIndices;
+	firstFourPoints.clear();
+	remainingIndices.clear();
+	auto pickPoint = [&](size_t index) {
+		const Point& thePoint = points[index];
+		switch (firstFourPoints.size()) {
+		case 0:
+			firstFourPoints.push_back(thePoint);
+			break;
+		case 1:
+			if (thePoint != firstFourPoints[0] && (tolerance <= 0 || squaredLength(thePoint - firstFourPoints[0]) > tolerance * tolerance)) {
+				firstFourPoints.push_back(thePoint);
+			}
+			else {
+				remainingIndices.push_back(index);
+			}
+			break;
+		case 2:
+		{
+			auto lineVector = firstFourPoints[1] - firstFourPoints[0];
+			if (!collinear(thePoint, firstFourPoints[0], firstFourPoints[1]) &&
+				(tolerance <= 0 || squaredLength(vectorProduct(lineVector, thePoint - firstFourPoints[0])) > tolerance * tolerance * squaredLength(lineVector))) {
+				firstFourPoints.push_back(thePoint);
+			}
+			else {
+				remainingIndices.push_back(index);
+			}
+			break;
+		}
+		case 3:
+		{
+			F orientationValue = orientation(firstFourPoints[0], firstFourPoints[1], firstFourPoints[2], thePoint);
+			bool withinTolerance = false;
+			if (tolerance > 0) {
+				auto normalVector = vectorProduct(firstFourPoints[1] - firstFourPoints[0], firstFourPoints[2] - firstFourPoints[0]);
+				withinTolerance = std::abs(double(orientationValue)) <= tolerance * std::sqrt(squaredLength(normalVector));
+			}
+
+			if (orientationValue == F(0) || withinTolerance) {
+				remainingIndices.push_back(index);
+			}
+			else if (orientationValue > F(0)) {
+				firstFourPoints.push_back(thePoint);
+			}
+			else {
+				std::swap(firstFourPoints[0], firstFourPoints[1]);
+				firstFourPoints.push_back(thePoint);
+			}
+			break;
+		}
+		default:
+			remainingIndices.push_back(index);
+		}
+	};
+
+	// Go through the extreme points first, so that the initial tetrahedron is picked from them
+	std::vector<size_t> simplex;
+	std::vector<bool> isInSimplex;
+	if (m_options.extremeInitialSimplex) {
+		simplex = findExtremeSimplex(points, m_options.execution);
+		isInSimplex.resize(points.size());
+		for (size_t index : simplex) {
+			isInSimplex[index] = true;
+			pickPoint(index);
+		}
+	}
+
+	for (size_t i = 0; i < points.size(); i++) {
+		if (isInSimplex.empty() || !isInSimplex[i]) {
+			pickPoint(i);
+		}
+	}
+
+	if (firstFourPoints.size() < 3) {
+		// All points are on the same line, keep only its two extremes
+		if (firstFourPoints.size()) {
+			Point lowest = firstFourPoints[0], highest = firstFourPoints[0];
+			auto extend = [&](const Point& thePoint) {
+				if (thePoint < lowest) {
+					lowest = thePoint;
+				}
+				if (highest < thePoint) {
+					highest = thePoint;
+				}
+			};
+
+			for (const Point& thePoint : firstFourPoints) {
+				extend(thePoint);
+			}
+			for (size_t index : remainingIndices) {
+				extend(points[index]);
+			}
+
+			m_degeneratePoints.push_back(lowest);
+			if (highest != lowest) {
+				m_degeneratePoints.push_back(highest);
+			}
+		}
+		return;
+	}
+
+	if (firstFourPoints.size() == 3) {
+		// All points are on the same plane
+		// Do the classical convex hull algorithm and keep only its vertices. The hull of the
+		// remaining points is computed in place, then again together with the first three.
+		point<F> normalVector = vectorProduct(firstFourPoints[1] - firstFourPoints[0], firstFourPoints[2] - firstFourPoints[0]);
+		std::vector<Point> planarPoints;
+		if (remainingIndices.size()) {
+			planarPoints = planarConvexHull(indexed_point_source<joined_points<Source>>{ points, remainingIndices }, normalVector, m_options.execution);
+
+			// The hull of a single distinct point is empty
+			if (planarPoints.empty()) {
+				planarPoints.push_back(points[remainingIndices[0]]);
+			}
+		}
+
+		planarPoints.insert(planarPoints.end(), firstFourPoints.begin(), firstFourPoints.end());
+		m_degeneratePoints = planarConvexHull(planarPoints, normalVector, m_options.execution);
+
+		// The polygon of the previous insertion is replaced
+		destroyGraph(m_planarVertex);
+		faceptr innerFace = makePolygon(m_degeneratePoints);
+		m_planarVertex = innerFace->outerComponent()->origin();
+
+		if (m_options.triangulate) {
+			// Both sides of the polygon, fanning out from different vertices
+			faceptr outerFace = innerFace->outerComponent()->twin()->incidentFace();
+			triangulateFace(innerFace);
+			triangulateFace(outerFace);
+		}
+		return;
+	}
+
+	destroyGraph(m_planarVertex);
+	m_planarVertex = nullptr;
+
+	faceptr baseTriangle = makeTriangle(firstFourPoints[0], firstFourPoints[1], firstFourPoints[2]);
+	m_peakVertex = inscribeVertex(baseTriangle, firstFourPoints[3]);
+	m_innerPoint = averagePoint(firstFourPoints);
+
+	count(&convex_hull_statistics::facesCreated, 4);
+	if (m_options.coplanarityTolerance > 0 && !m_options.triangulate) {
+		for (const edgeptr& theEdge : exploreGraph(m_peakVertex)) {
+			if (theEdge == theEdge->incidentFace()->outerComponent()) {
+				m_unmergedFaces.push_back(theEdge->incidentFace());
+			}
+		}
+	}
+	if (m_trackDelta) {
+		m_createdVertices.clear();
+		m_createdFaces.clear();
+		m_createdEdges.clear();
+		m_removedVertices.clear();
+		m_removedFaces.clear();
+		m_removedEdges.clear();
+		for (const edgeptr& theEdge : exploreGraph(m_peakVertex)) {
+			m_createdVertices.insert(theEdge->origin());
+			m_createdFaces.insert(theEdge->incidentFace());
+			m_createdEdges.insert(theEdge);
+		}
+	}
+
+	notify(callback, convex_hull_update::initialTetrahedron);
+
+	insertOutsidePoints(points, remainingIndices, callback);
+}
+
+/*
+ * Finds the faces the point is outside of by walking over the graph from a face around the peak
+ * vertex, like hull_face_locator does over its own copy of the faces, so that adding a few points
+ * to a large hull doesn't go through all of its faces. Each face is scored with its normal scaled
+ * by the distance of its plane from the inner point, and the walk moves to better neighbors until
+ * it reaches the best face. Returns false if the point can't be told apart from the boundary in
+ * floating point, or the hull is too thin, in which case it should be tested against all faces.
+ * Only for hulls without coplanar faces, which rules out the tolerance and triangulation.
+ */
+template<class Point>
+bool incremental_convex_hull<Point>::locateByWalking(const Point& thePoint, std::vector<faceptr>& visibleFaces) {
+	using namespace hullgraph;
+
+	// Points whose best score is within this of one are tested against all faces
+	const double margin = 1e-6;
+
+	point<double> offset = toDouble(thePoint) - m_innerPoint;
+	bool isUsable = true;
+	auto score = [&](const faceptr& theFace) {
+		edgeptr walkingEdge = theFace->outerComponent();
+		point<double> a = toDouble(walkingEdge->origin()->data());
+		point<double> b = toDouble(walkingEdge->next()->origin()->data());
+		point<double> c = toDouble(walkingEdge->next()->destination()->data());
+		point<double> normal = vectorProduct(b - a, c - a);
+		double reach = scalarProduct(normal, a - m_innerPoint);
+		if (!(reach > 0)) {
+			isUsable = false;
+			return 0.0;
+		}
 
-	std::vector<Point> firstFourPoints, remainingPoints;
-	for (const Point& point : points) {
-		switch (firstFourPoints.size()) {
-		case 0:
-			firstFourPoints.push_back(point);
-			break;
-		case 1:
-			if (point != firstFourPoints[0]) {
-				firstFourPoints.push_back(point);
-			}
-			else {
-				remainingPoints.push_back(point);
-			}
-			break;
-		case 2:
-			if (!collinear(point, firstFourPoints[0], firstFourPoints[1])) {
-				firstFourPoints.push_back(point);
+		return scalarProduct(normal, offset) / reach;
+	};
+
+	std::vector<edgeptr>& faceEdges = currentWorkspace().m_faceEdges;
+	faceptr current = m_peakVertex->incidentEdge()->incidentFace();
+	double value = score(current);
+	for (faceptr previous; previous != current && isUsable;) {
+		previous = current;
+		faceToEdgeList(previous, faceEdges);
+		for (const edgeptr& faceEdge : faceEdges) {
+			faceptr neighbor = faceEdge->twin()->incidentFace();
+			double neighborValue = score(neighbor);
+			if (neighborValue > value) {
+				current = neighbor;
+				value = neighborValue;
 			}
-			else {
-				remainingPoints.push_back(point);
+		}
+	}
+
+	if (!isUsable) {
+		return false;
+	}
+
+	if (!isOutside(current, thePoint)) {
+		return !(value > 1 - margin);
+	}
+
+	// The faces the point is outside of are connected
+	auto& visitedFaces = currentWorkspace().m_faceSet;
+	visitedFaces.insert(current);
+	visibleFaces.push_back(current);
+	for (size_t k = 0; k < visibleFaces.size(); k++) {
+		faceToEdgeList(visibleFaces[k], faceEdges);
+		for (const edgeptr& faceEdge : faceEdges) {
+			faceptr neighbor = faceEdge->twin()->incidentFace();
+			if (visitedFaces.insert(neighbor).second && isOutside(neighbor, thePoint)) {
+				visibleFaces.push_back(neighbor);
 			}
-			break;
-		case 3:
-		{
-			F orientationValue = orientation(firstFourPoints[0], firstFourPoints[1], firstFourPoints[2], point);
-			if (orientationValue == F(0)) {
-				remainingPoints.push_back(point);
+		}
+	}
+
+	visitedFaces.clear();
+	return true;
+}
+
+/*
+ * Removes a vertex of a full-dimensional hull by repairing the hole it leaves, given the
+ * candidates, a set of points inside of the hull which includes every point that becomes a
+ * vertex once the given one is gone. The hull of the neighbors of the vertex and the candidates
+ * is computed, and its faces on the outer side of the ring of neighbors replace the faces around
+ * the vertex, so that the rest of the graph is left as it is. The vertices added from the
+ * candidates are stored in newVertices. The change isn't reported to callbacks.
+ * Returns false without changing anything if the hull has a tolerance, if the remaining points
+ * are coplanar, or if the patch doesn't fit the hole because of degenerate candidates, in which
+ * case the hull should be built again from the remaining points.
+ */
+template<class Point>
+bool incremental_convex_hull<Point>::eraseVertex(const vertexptr& theVertex, const std::vector<Point>& candidates, std::vector<vertexptr>& newVertices) {
+	using namespace hullgraph;
+
+	newVertices.clear();
+	if (!m_peakVertex || m_options.coplanarityTolerance > 0) {
+		return false;
+	}
+
+	// The faces around the vertex, and the ring of edges around them in the same direction
+	std::vector<faceptr> starFaces;
+	std::vector<edgeptr> borderEdges;
+	for (const edgeptr& outEdge : adjacentEdges(theVertex)) {
+		starFaces.push_back(outEdge->incidentFace());
+		for (edgeptr borderEdge = outEdge->next(); borderEdge != outEdge->prev(); borderEdge = borderEdge->next()) {
+			borderEdges.push_back(borderEdge);
+		}
+	}
+
+	bool isFlat = true;
+	for (const edgeptr& borderEdge : borderEdges) {
+		isFlat &= borderEdge->twin()->incidentFace() == borderEdges[0]->twin()->incidentFace();
+	}
+
+	if (isFlat) {
+		return false;
+	}
+
+	convex_hull_options patchOptions = m_options;
+	patchOptions.cancellationToken = nullptr;
+	patchOptions.deadline = std::chrono::steady_clock::time_point::max();
+
+	std::vector<Point> patchPoints;
+	std::map<point<F>, vertexptr> borderVertices;
+	for (const edgeptr& borderEdge : borderEdges) {
+		const Point& thePoint = borderEdge->origin()->data();
+		patchPoints.push_back(thePoint);
+		borderVertices[point<F>{ thePoint.x, thePoint.y, thePoint.z }] = borderEdge->origin();
+	}
+
+	patchPoints.insert(patchPoints.end(), candidates.begin(), candidates.end());
+	incremental_convex_hull<Point> patch(patchOptions);
+	patch.insert(std::move(patchPoints));
+
+	// The graph of the patch is freed unless it's spliced into the hull
+	auto discardPatch = [&]() {
+		destroyGraph(patch.vertex());
+		return false;
+	};
+
+	if (!patch.isFullDimensional()) {
+		// The neighbors lie on a plane, and are the vertices of the single face replacing the
+		// faces around the vertex
+		std::vector<Point> planarVertices = patch.vertices();
+		if (planarVertices.size() != borderEdges.size()) {
+			return discardPatch();
+		}
+
+		for (const Point& thePoint : planarVertices) {
+			if (!borderVertices.count(point<F>{ thePoint.x, thePoint.y, thePoint.z })) {
+				return discardPatch();
 			}
-			else if (orientationValue > F(0)) {
-				firstFourPoints.push_back(point);
+		}
+
+		// The old inner point may be outside of the new face. The middle of a point inside of
+		// the face and a vertex off its plane, such as one of a face next to it, is strictly inside.
+		vertexptr offPlaneVertex;
+		for (const edgeptr& faceEdge : faceToEdgeList(borderEdges[0]->twin()->incidentFace())) {
+			const Point& thePoint = faceEdge->origin()->data();
+			if (!borderVertices.count(point<F>{ thePoint.x, thePoint.y, thePoint.z })) {
+				offPlaneVertex = faceEdge->origin();
 			}
-			else {
-				std::swap(firstFourPoints[0], firstFourPoints[1]);
-				firstFourPoints.push_back(point);
+		}
+
+		if (!offPlaneVertex) {
+			return discardPatch();
+		}
+
+		point<double> faceCenter = averagePoint(planarVertices);
+		point<double> offPlanePoint = toDouble(offPlaneVertex->data());
+		m_innerPoint = { (faceCenter.x + offPlanePoint.x) / 2, (faceCenter.y + offPlanePoint.y) / 2, (faceCenter.z + offPlanePoint.z) / 2 };
+
+		discardPatch();
+		faceptr newFace = joinFaces(starFaces).newFace;
+		m_peakVertex = newFace->outerComponent()->origin();
+		if (m_options.triangulate) {
+			triangulateFace(newFace);
+		}
+
+		return true;
+	}
+
+	// Each edge of the ring is an edge of the patch, between the same points
+	std::vector<edgeptr> patchEdges = exploreGraph(patch.vertex());
+	std::map<point<F>, vertexptr> patchVertices;
+	for (const edgeptr& patchEdge : patchEdges) {
+		const Point& thePoint = patchEdge->origin()->data();
+		patchVertices[point<F>{ thePoint.x, thePoint.y, thePoint.z }] = patchEdge->origin();
+	}
+
+	auto findPatchVertex = [&](const vertexptr& borderVertex) {
+		const Point& thePoint = borderVertex->data();
+		auto it = patchVertices.find(point<F>{ thePoint.x, thePoint.y, thePoint.z });
+		return it == patchVertices.end() ? vertexptr() : it->second;
+	};
+
+	std::vector<edgeptr> matchingEdges;
+	std::unordered_set<edgeptr> ringEdges;
+	for (const edgeptr& borderEdge : borderEdges) {
+		vertexptr origin = findPatchVertex(borderEdge->origin());
+		vertexptr destination = findPatchVertex(borderEdge->destination());
+		if (!origin || !destination) {
+			return discardPatch();
+		}
+
+		edgeptr matchingEdge;
+		for (const edgeptr& outEdge : adjacentEdges(origin)) {
+			if (outEdge->destination() == destination) {
+				matchingEdge = outEdge;
 			}
-			break;
 		}
-		default:
-			remainingPoints.push_back(point);
+
+		if (!matchingEdge) {
+			return discardPatch();
 		}
+
+		matchingEdges.push_back(matchingEdge);
+		ringEdges.insert(matchingEdge);
+		ringEdges.insert(matchingEdge->twin());
 	}
 
-	if (firstFourPoints.size() < 3) {
-		// All points are on the same line
-		return nullptr;
+	// The faces on the outer side of the ring are the new faces of the hull. The ring splits
+	// the patch in two unless the candidates were degenerate.
+	std::unordered_set<faceptr> newFaces;
+	std::vector<faceptr> newFaceList;
+	for (const edgeptr& matchingEdge : matchingEdges) {
+		if (newFaces.insert(matchingEdge->incidentFace()).second) {
+			newFaceList.push_back(matchingEdge->incidentFace());
+		}
 	}
 
-	if (firstFourPoints.size() == 3) {
-		// All points are on the same plane
-		// Do the classical convex hull algorithm
-		point<F> normalVector = vectorProduct(firstFourPoints[1] - firstFourPoints[0], firstFourPoints[2] - firstFourPoints[0]);
+	for (size_t k = 0; k < newFaceList.size(); k++) {
+		for (const edgeptr& faceEdge : faceToEdgeList(newFaceList[k])) {
+			faceptr neighbor = faceEdge->twin()->incidentFace();
+			if (!ringEdges.count(faceEdge) && newFaces.insert(neighbor).second) {
+				newFaceList.push_back(neighbor);
+			}
+		}
+	}
 
-		auto leftTurn = [&](size_t a, size_t b, size_t c) {
-			return scalarProduct(normalVector, vectorProduct(points[b] - points[a], points[c] - points[a])) > F(0);
-		};
+	std::vector<faceptr> innerFaces;
+	for (const edgeptr& patchEdge : patchEdges) {
+		faceptr theFace = patchEdge->incidentFace();
+		if (patchEdge == theFace->outerComponent() && !newFaces.count(theFace)) {
+			innerFaces.push_back(theFace);
+		}
+	}
+
+	for (const edgeptr& matchingEdge : matchingEdges) {
+		if (newFaces.count(matchingEdge->twin()->incidentFace())) {
+			return discardPatch();
+		}
+	}
 
-		std::vector<size_t> pointStack[2], pointOrdering(points.size());
-		std::iota(pointOrdering.begin(), pointOrdering.end(), size_t(0));
-		std::sort(pointOrdering.begin(), pointOrdering.end(), [&](size_t i, size_t j) {
-			return points[i] < points[j];
-			});
+	// Both the faces around the vertex and the inner faces of the patch become a single face
+	// bounded by the ring, and the patch takes the place of the hole
+	vertexptr ringVertex = borderEdges[0]->origin();
+	std::unordered_set<vertexptr> ringVertices;
+	for (const edgeptr& borderEdge : borderEdges) {
+		ringVertices.insert(borderEdge->origin());
+	}
 
-		for (int stackNum : {0, 1}) {
-			std::vector<size_t>& stack = pointStack[stackNum];
-			for (size_t i : pointOrdering) {
-				while (stack.size() >= 2 && leftTurn(stack[stack.size() - 1], stack[stack.size() - 2], i)) {
-					stack.pop_back();
-				}
-				stack.push_back(i);
+	joinFaces(innerFaces);
+	edgeptr holeEdge = joinFaces(starFaces).newFace->outerComponent();
+	size_t holeIndex = std::find(borderEdges.begin(), borderEdges.end(), holeEdge) - borderEdges.begin();
+	spliceFaces(holeEdge, matchingEdges[holeIndex]->twin());
+
+	std::unordered_set<vertexptr> visitedVertices;
+	for (const faceptr& newFace : newFaceList) {
+		for (const edgeptr& faceEdge : faceToEdgeList(newFace)) {
+			vertexptr faceVertex = faceEdge->origin();
+			if (!ringVertices.count(faceVertex) && visitedVertices.insert(faceVertex).second) {
+				newVertices.push_back(faceVertex);
 			}
-			stack.pop_back();
-			std::reverse(pointOrdering.begin(), pointOrdering.end());
 		}
+	}
 
-		pointStack[0].insert(pointStack[0].end(), pointStack[1].begin(), pointStack[1].end());
+	m_peakVertex = ringVertex;
 
-		std::vector<Point> hullPoints(pointStack[0].size());
-		for (size_t i = 0; i < pointStack[0].size(); i++) {
-			hullPoints[i] = points[pointStack[0][i]];
+	// The hull has shrunk, and the old inner point may be outside of the new faces. The inner
+	// point of the patch is inside of the patch, which is inside of the hull.
+	for (const faceptr& newFace : newFaceList) {
+		edgeptr faceEdge = newFace->outerComponent();
+		point<double> a = toDouble(faceEdge->origin()->data());
+		point<double> b = toDouble(faceEdge->next()->origin()->data());
+		point<double> c = toDouble(faceEdge->next()->destination()->data());
+		if (!(scalarProduct(vectorProduct(b - a, c - a), a - m_innerPoint) > 0)) {
+			m_innerPoint = patch.m_innerPoint;
+			break;
 		}
+	}
 
-		return makePolygon(hullPoints)->outerComponent()->origin();
+	return true;
+}
+
+/*
+ * Adds all faces of the hull to the given vector, by walking from a face to its neighbors.
+ */
+template<class Point>
+void incremental_convex_hull<Point>::collectFaces(std::vector<faceptr>& faces) {
+	hull_workspace<Point>& workspace = currentWorkspace();
+	auto& visitedFaces = workspace.m_allFaceSet;
+	size_t firstFace = faces.size();
+	faces.push_back(m_peakVertex->incidentEdge()->incidentFace());
+	visitedFaces.insert(faces.back());
+	for (size_t k = firstFace; k < faces.size(); k++) {
+		hullgraph::faceToEdgeList(faces[k], workspace.m_faceEdges);
+		for (const edgeptr& faceEdge : workspace.m_faceEdges) {
+			faceptr neighbor = faceEdge->twin()->incidentFace();
+			if (visitedFaces.insert(neighbor).second) {
+				faces.push_back(neighbor);
+			}
+		}
 	}
 
-	faceptr baseTriangle = makeTriangle(firstFourPoints[0], firstFourPoints[1], firstFourPoints[2]);
-	vertexptr peakVertex = inscribeVertex(baseTriangle, firstFourPoints[3]);
+	visitedFaces.clear();
+}
+
+template<class Point>
+template<class Source, class Callback>
+void incremental_convex_hull<Point>::insertOutsidePoints(const Source& points, std::vector<size_t>& remainingIndices, Callback& callback) {
+	using namespace hullgraph;
+
+	// Initialize the conflict graph. Its containers and the scratch vectors below come from the
+	// workspace, which gets them back empty at the end.
+	hull_workspace<Point>& workspace = currentWorkspace();
+
+	// shuffle the remaining points, the conflict graph refers to them by their position in this order
+	std::shuffle(remainingIndices.begin(), remainingIndices.end(), workspace.m_rngEngine);
+	workspace.reservePoints(remainingIndices.size());
+
+	auto& pointToFaces = workspace.m_pointToFaces;
+	auto& faceToPoints = workspace.m_faceToPoints;
+
+	auto conflictList = [&](const faceptr& theFace) -> std::vector<size_t>& {
+		auto mapIt = faceToPoints.find(theFace);
+		if (mapIt == faceToPoints.end()) {
+			mapIt = faceToPoints.emplace(theFace, workspace.takeList()).first;
+		}
+
+		return mapIt->second;
+	};
 
-	callback(convex_hull_update::initialTetrahedron, peakVertex);
+	auto eraseConflictList = [&](decltype(faceToPoints.begin()) mapIt) {
+		workspace.giveList(mapIt->second);
+		faceToPoints.erase(mapIt);
+	};
+
+	// A few points are located by walking over the graph, so that their cost doesn't grow with
+	// the size of the hull. Without the tolerance and triangulation no two faces are coplanar.
+	const size_t minLocatedPoints = 1 << 4;
+	bool canWalk = m_options.coplanarityTolerance <= 0 && !m_options.triangulate;
+	if (canWalk && remainingIndices.size() < minLocatedPoints) {
+		std::vector<faceptr>& visibleFaces = workspace.m_faces;
+		std::vector<faceptr>& allFaces = workspace.m_allFaces;
+		for (size_t j = 0; j < remainingIndices.size(); j++) {
+			const Point& thePoint = points[remainingIndices[j]];
+			visibleFaces.clear();
+			if (!locateByWalking(thePoint, visibleFaces)) {
+				if (allFaces.empty()) {
+					collectFaces(allFaces);
+				}
+
+				for (const faceptr& theFace : allFaces) {
+					if (isOutside(theFace, thePoint)) {
+						visibleFaces.push_back(theFace);
+					}
+				}
+			}
+
+			for (const faceptr& visibleFace : visibleFaces) {
+				pointToFaces[j].insert(visibleFace);
+				conflictList(visibleFace).push_back(j);
+			}
+			count(&convex_hull_statistics::conflictInserts, visibleFaces.size());
+		}
 
-	// shuffle the remaining points
-	{
-		static std::mt19937_64 rngEngine(std::chrono::high_resolution_clock::now().time_since_epoch().count());
-		std::shuffle(remainingPoints.begin(), remainingPoints.end(), rngEngine);
+		visibleFaces.clear();
+		allFaces.clear();
+		for (auto& entry : faceToPoints) {
+			countConflictList(entry.second.size());
+		}
 	}
+	else {
+		std::vector<faceptr>& faces = workspace.m_faces;
+		collectFaces(faces);
+
+		// The points are split into blocks tested in parallel. Each point's set of faces is only
+		// touched by its own block, and the conflicts each block finds for a face are appended
+		// to its list in the order of the blocks, which gives the same lists as a single pass.
+		execution_policy blockExecution = m_options.execution.forItems(remainingIndices.size());
+		std::vector<std::vector<std::vector<size_t>>>& blockConflicts = workspace.m_blockConflicts;
+		if (blockConflicts.size() < blockExecution.threadCount) {
+			blockConflicts.resize(blockExecution.threadCount);
+		}
+		for (size_t blockIndex = 0; blockIndex < blockExecution.threadCount; blockIndex++) {
+			if (blockConflicts[blockIndex].size() < faces.size()) {
+				blockConflicts[blockIndex].resize(faces.size());
+			}
+		}
+
+		// Points added to a hull which already has many faces, such as a finished one, are
+		// located on it instead of being tested against every face
+		const size_t minLocatedFaces = 1 << 6;
+		std::optional<hull_face_locator<Point>> locator;
+		if (canWalk && faces.size() >= minLocatedFaces) {
+			locator.emplace(faces);
+			if (!locator->isUsable()) {
+				locator.reset();
+			}
+		}
+
+		std::vector<typename hull_face_locator<Point>::scratch>& blockScratch = workspace.m_blockScratch;
+		blockScratch.resize(blockExecution.threadCount);
+		for (auto& theScratch : blockScratch) {
+			theScratch.startFace = 0;
+			theScratch.orientationTests = 0;
+		}
+		// Testing every point against every face is where large inputs spend their time, so the
+		// token and the deadline are also checked every few points here. If they stop it, no
+		// point is added and the hull stays as it was.
+		const size_t stopCheckInterval = 1 << 6;
+		std::atomic<bool> isStopped(false);
+		size_t blockCount = parallelBlocks(remainingIndices.size(), blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+			for (size_t j = begin; j < end; j++) {
+				if ((j - begin) % stopCheckInterval == 0 && (isStopped.load(std::memory_order_relaxed) || shouldStop())) {
+					isStopped = true;
+					end = j;
+					break;
+				}
 
-	// Initialize the conflict graph
-	std::vector<std::unordered_set<faceptr>> pointToFaces(remainingPoints.size());
-	std::unordered_map<faceptr, std::vector<size_t>> faceToPoints;
+				const Point& thePoint = points[remainingIndices[j]];
+				if (locator) {
+					locator->locate(thePoint, blockScratch[blockIndex], [&](const faceptr& theFace, const Point& p) {
+						return isOutsideUncounted(theFace, p);
+					}, [&](size_t i) {
+						pointToFaces[j].insert(faces[i]);
+						blockConflicts[blockIndex][i].push_back(j);
+					});
+					continue;
+				}
+
+				for (size_t i = 0; i < faces.size(); i++) {
+					if (isOutsideUncounted(faces[i], thePoint)) {
+						pointToFaces[j].insert(faces[i]);
+						blockConflicts[blockIndex][i].push_back(j);
+					}
+				}
+			}
 
-	{
-		faceptr faces[4];
-		edgeptr walkingEdge = peakVertex->incidentEdge();
-		faces[0] = walkingEdge->incidentFace();
-		walkingEdge = walkingEdge->twin();
-		faces[1] = walkingEdge->incidentFace();
-		walkingEdge = walkingEdge->next()->twin();
-		faces[2] = walkingEdge->incidentFace();
-		walkingEdge = walkingEdge->prev()->twin();
-		faces[3] = walkingEdge->incidentFace();
+			if (!locator) {
+				blockScratch[blockIndex].orientationTests = faces.size() * (end - begin);
+			}
+		});
 
-		for (size_t i = 0; i < 4; i++) {
-			for (size_t j = 0; j < remainingPoints.size(); j++) {
-				if (facePointOrientation(faces[i], remainingPoints[j]) > F(0)) {
-					pointToFaces[j].insert(faces[i]);
-					faceToPoints[faces[i]].push_back(j);
+		for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+			count(&convex_hull_statistics::orientationTests, blockScratch[blockIndex].orientationTests);
+		}
+		if (isStopped) {
+			m_isPartial = true;
+			for (size_t j = 0; j < remainingIndices.size(); j++) {
+				pointToFaces[j].clear();
+			}
+			for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+				for (size_t i = 0; i < faces.size(); i++) {
+					blockConflicts[blockIndex][i].clear();
 				}
 			}
 		}
+		for (size_t i = 0; i < faces.size() && !isStopped; i++) {
+			std::vector<size_t>& faceConflicts = conflictList(faces[i]);
+			for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+				faceConflicts.insert(faceConflicts.end(), blockConflicts[blockIndex][i].begin(), blockConflicts[blockIndex][i].end());
+				blockConflicts[blockIndex][i].clear();
+			}
+
+			count(&convex_hull_statistics::conflictInserts, faceConflicts.size());
+			countConflictList(faceConflicts.size());
+		}
+
+		faces.clear();
 	}
 
 	// Add the points
-	for (size_t i = 0; i < remainingPoints.size(); i++) {
+	for (size_t i = 0; i < remainingIndices.size(); i++) {
 		if (pointToFaces[i].size()) {
-			std::vector<faceptr> faceSetToVector(pointToFaces[i].begin(), pointToFaces[i].end());
-			join_faces_result<Point> joinResult = joinFaces(faceSetToVector);
-			callback(convex_hull_update::afterJoinFaces, peakVertex);
+			if (shouldStop()) {
+				m_isPartial = true;
+				break;
+			}
+
+			Point newPoint = points[remainingIndices[i]];
+			std::vector<faceptr>& faceSetToVector = workspace.m_faces;
+			faceSetToVector.assign(pointToFaces[i].begin(), pointToFaces[i].end());
+			if (m_options.coplanarityTolerance > 0) {
+				// Only the faces the point is farther than the tolerance from are in the conflict
+				// graph, the faces it barely sees are found around them
+				auto& visibleFaces = workspace.m_faceSet;
+				visibleFaces.insert(pointToFaces[i].begin(), pointToFaces[i].end());
+				for (size_t k = 0; k < faceSetToVector.size(); k++) {
+					faceToEdgeList(faceSetToVector[k], workspace.m_faceEdges);
+					for (const edgeptr& faceEdge : workspace.m_faceEdges) {
+						faceptr neighborFace = faceEdge->twin()->incidentFace();
+						count(&convex_hull_statistics::orientationTests);
+						if (!visibleFaces.count(neighborFace) && facePointOrientation(neighborFace, newPoint) > F(0)) {
+							visibleFaces.insert(neighborFace);
+							faceSetToVector.push_back(neighborFace);
+						}
+					}
+				}
 
-			std::vector<vertexptr> borderVertices(joinResult.borderEdges.size());
-			for (size_t i = 0; i < joinResult.borderEdges.size(); i++) {
-				borderVertices[i] = joinResult.borderEdges[i]->origin();
+				visibleFaces.clear();
 			}
 
-			vertexptr newVertex = inscribeVertex(joinResult.newFace, remainingPoints[i]);
-			peakVertex = newVertex;
-			callback(convex_hull_update::afterInscribeVertex, peakVertex);
+			graph_snapshot snapshot = beginChange(faceSetToVector);
+			join_faces_result<Point>& joinResult = workspace.m_joinResult;
+			joinFaces(faceSetToVector, joinResult);
+			endChange(snapshot, { joinResult.newFace });
+			count(&convex_hull_statistics::joinFacesCalls);
+			count(&convex_hull_statistics::horizonLength, joinResult.borderEdges.size());
+			notify(callback, convex_hull_update::afterJoinFaces);
+
+			std::vector<vertexptr>& borderVertices = workspace.m_borderVertices;
+			borderVertices.clear();
+			for (const edgeptr& borderEdge : joinResult.borderEdges) {
+				borderVertices.push_back(borderEdge->origin());
+			}
 
-			std::vector<edgeptr> newVertexEdges = adjacentEdges(newVertex);
-			std::vector<bool> shouldMerge(newVertexEdges.size(), false);
-			std::vector<bool> shouldSkip(newVertexEdges.size(), false);
+			snapshot = beginChange({ joinResult.newFace });
+			vertexptr newVertex = inscribeVertex(joinResult.newFace, newPoint);
+			m_peakVertex = newVertex;
+			std::vector<edgeptr>& newVertexEdges = workspace.m_newVertexEdges;
+			adjacentEdges(newVertex, newVertexEdges);
+			if (m_trackDelta) {
+				std::vector<faceptr> newTriangles;
+				for (const edgeptr& newVertexEdge : newVertexEdges) {
+					newTriangles.push_back(newVertexEdge->incidentFace());
+				}
+				endChange(snapshot, newTriangles);
+			}
+			count(&convex_hull_statistics::facesCreated, newVertexEdges.size());
+			if (m_options.coplanarityTolerance > 0 && !m_options.triangulate) {
+				for (const edgeptr& newVertexEdge : newVertexEdges) {
+					m_unmergedFaces.push_back(newVertexEdge->incidentFace());
+				}
+			}
+			notify(callback, convex_hull_update::afterInscribeVertex);
+			std::vector<bool>& shouldMerge = workspace.m_shouldMerge;
+			std::vector<bool>& shouldSkip = workspace.m_shouldSkip;
+			shouldMerge.assign(newVertexEdges.size(), false);
+			shouldSkip.assign(newVertexEdges.size(), false);
 
-			// Check whether the i-th new face should be merged
+			// Check whether the i-th new face should be merged. When triangulating, only zero-area
+			// triangles are merged into their neighbors.
+			bool anyMerge = false;
 			for (size_t j = 0; j < newVertexEdges.size(); j++) {
-				faceptr newTriangle = newVertexEdges[j]->incidentFace();
-				vertexptr adjacentVertex = newVertexEdges[j]->next()->twin()->next()->destination();
-				if (facePointOrientation(newTriangle, adjacentVertex->data()) == F(0)) {
-					shouldMerge[j] = true;
+				if (m_options.triangulate) {
+					shouldMerge[j] = collinear(newVertex->data(), newVertexEdges[j]->destination()->data(), newVertexEdges[j]->next()->destination()->data());
 				}
+				else {
+					faceptr newTriangle = newVertexEdges[j]->incidentFace();
+					vertexptr adjacentVertex = newVertexEdges[j]->next()->twin()->next()->destination();
+					count(&convex_hull_statistics::orientationTests);
+					shouldMerge[j] = facePointOrientation(newTriangle, adjacentVertex->data()) == F(0);
+				}
+				anyMerge |= shouldMerge[j];
 			}
 
+			std::vector<faceptr>& mergedFaces = workspace.m_mergedFaces;
+			mergedFaces.clear();
+
 			// First, merge adjacent coplanar new triangles
 			for (size_t j = 0; j < newVertexEdges.size(); j++) {
 				size_t jNext = j == newVertexEdges.size() - 1 ? 0 : j + 1;
@@ -201,7 +1877,8 @@ std::shared_ptr<hullgraph::vertex<Point>> computeConvexHull3D(const std::vector<
 
 			for (size_t j = 0; j < newVertexEdges.size(); j++) {
 				if (shouldSkip[j]) {
-					removeEdge(newVertexEdges[j]);
+					removeEdgeTracked(newVertexEdges[j]);
+					count(&convex_hull_statistics::facesMerged);
 				}
 			}
 
@@ -214,39 +1891,53 @@ std::shared_ptr<hullgraph::vertex<Point>> computeConvexHull3D(const std::vector<
 				if (shouldMerge[j]) {
 					// Merge the two faces and adjust the conflict graph
 					faceptr adjacentFace = newVertexEdges[j]->next()->twin()->incidentFace();
-					faceptr mergedFace = removeEdge(newVertexEdges[j]->next());
-					std::swap(faceToPoints[mergedFace], faceToPoints[adjacentFace]);
-					faceToPoints.erase(adjacentFace);
-					for (size_t pointIdx : faceToPoints[mergedFace]) {
+					faceptr mergedFace = removeEdgeTracked(newVertexEdges[j]->next());
+					mergedFaces.push_back(mergedFace);
+					if (m_options.coplanarityTolerance > 0) {
+						m_unmergedFaces.push_back(mergedFace);
+					}
+					count(&convex_hull_statistics::facesMerged);
+					std::vector<size_t>& mergedConflicts = conflictList(mergedFace);
+					std::swap(mergedConflicts, conflictList(adjacentFace));
+					eraseConflictList(faceToPoints.find(adjacentFace));
+					for (size_t pointIdx : mergedConflicts) {
 						pointToFaces[pointIdx].erase(adjacentFace);
 						pointToFaces[pointIdx].insert(mergedFace);
 					}
+					count(&convex_hull_statistics::conflictErases, mergedConflicts.size());
+					count(&convex_hull_statistics::conflictInserts, mergedConflicts.size());
 				}
 				else {
 					// Check the union of the two faces around this edge
 					faceptr newTriangle = newVertexEdges[j]->incidentFace();
 					faceptr adjacentFace = newVertexEdges[j]->next()->twin()->incidentFace();
-					std::unordered_set<size_t> newConflicts;
+					auto& newConflicts = workspace.m_newConflicts;
+					newConflicts.clear();
 
 					for (const faceptr& interestingFace : { joinResult.borderFaces[j], adjacentFace }) {
 						auto mapIt = faceToPoints.find(interestingFace);
 						if (mapIt != faceToPoints.end()) {
 							for (size_t pointIdx : mapIt->second) {
-								if (facePointOrientation(newTriangle, remainingPoints[pointIdx]) > F(0)) {
-									newConflicts.insert(pointIdx);
+								if (isOutside(newTriangle, points[remainingIndices[pointIdx]])) {
+									newConflicts.push_back(pointIdx);
 								}
 							}
 						}
 					}
 
-					faceToPoints[newTriangle] = std::vector<size_t>(newConflicts.begin(), newConflicts.end());
+					// A point may conflict with both faces
+					std::sort(newConflicts.begin(), newConflicts.end());
+					newConflicts.erase(std::unique(newConflicts.begin(), newConflicts.end()), newConflicts.end());
+					conflictList(newTriangle).assign(newConflicts.begin(), newConflicts.end());
 					for (size_t pointIdx : newConflicts) {
 						pointToFaces[pointIdx].insert(newTriangle);
 					}
+					count(&convex_hull_statistics::conflictInserts, newConflicts.size());
+					countConflictList(newConflicts.size());
 				}
 			}
 
-			callback(convex_hull_update::afterMergeFaces, peakVertex);
+			notify(callback, convex_hull_update::afterMergeFaces);
 
 			// Delete removed faces from the conflict graph
 			for (const faceptr& facePtr : faceSetToVector) {
@@ -255,26 +1946,373 @@ std::shared_ptr<hullgraph::vertex<Point>> computeConvexHull3D(const std::vector<
 					for (size_t pointIdx : mapIt->second) {
 						pointToFaces[pointIdx].erase(facePtr);
 					}
-					faceToPoints.erase(mapIt);
+					count(&convex_hull_statistics::conflictErases, mapIt->second.size());
+					eraseConflictList(mapIt);
 				}
 			}
 
 			// Delete vertices worth deleting. The conflict graph isn't changed.
-			for (const vertexptr& borderVertex : borderVertices) {
-				// Some border vertices may have been deleted during face merger, skip them
-				if (borderVertex->incidentEdge()) {
-					removeRedundantVertex(borderVertex);
+			// Redundant vertices can only appear after faces have been merged.
+			if (anyMerge) {
+				for (const vertexptr& borderVertex : borderVertices) {
+					// Some border vertices may have been deleted during face merger, skip them
+					if (borderVertex->incidentEdge() && removeRedundantVertexTracked(borderVertex)) {
+						count(&convex_hull_statistics::redundantVerticesRemoved);
+					}
+				}
+			}
+
+			// Split the merged faces back into triangles. All pieces lie on the same plane,
+			// so each of them conflicts with the same points as the merged face.
+			if (m_options.triangulate) {
+				for (const faceptr& mergedFace : mergedFaces) {
+					if (!mergedFace->outerComponent()) {
+						continue;
+					}
+
+					snapshot = beginChange({ mergedFace });
+					std::vector<faceptr> triangles = triangulateFace(mergedFace);
+					endChange(snapshot, triangles);
+					count(&convex_hull_statistics::facesCreated, triangles.size() - 1);
+					auto mapIt = faceToPoints.find(mergedFace);
+					if (mapIt == faceToPoints.end()) {
+						continue;
+					}
+
+					const std::vector<size_t>& conflictingPoints = mapIt->second;
+					for (const faceptr& triangle : triangles) {
+						if (triangle == mergedFace) {
+							continue;
+						}
+
+						conflictList(triangle) = conflictingPoints;
+						for (size_t pointIdx : conflictingPoints) {
+							pointToFaces[pointIdx].insert(triangle);
+						}
+						count(&convex_hull_statistics::conflictInserts, conflictingPoints.size());
+					}
 				}
 			}
 
-			callback(convex_hull_update::afterRemoveRedundantVertices, peakVertex);
+			notify(callback, convex_hull_update::afterRemoveRedundantVertices);
 		}
 	}
 
-	return peakVertex;
+	workspace.clear(remainingIndices.size());
+
+	if (m_options.coplanarityTolerance > 0 && !m_options.triangulate) {
+		mergeNearlyCoplanarFaces(callback);
+	}
 }
 
 template<class Point>
-std::shared_ptr<hullgraph::vertex<Point>> computeConvexHull3D(const std::vector<Point>& points) {
-	return computeConvexHull3D(points, [](convex_hull_update, const std::shared_ptr<hullgraph::vertex<Point>>&) {});
+template<class Callback>
+void incremental_convex_hull<Point>::mergeNearlyCoplanarFaces(Callback& callback) {
+	using namespace hullgraph;
+
+	auto toDouble = [](const Point& thePoint) {
+		return point<double>{ double(thePoint.x), double(thePoint.y), double(thePoint.z) };
+	};
+
+	// The plane of a face is kept as an area weighted normal and the matching offset, so that
+	// the plane of two merged faces is simply the sum of the two.
+	struct face_plane {
+		point<double> normal;
+		double offset;
+
+		double distance(const point<double>& thePoint) const {
+			return (scalarProduct(normal, thePoint) - offset) / std::sqrt(scalarProduct(normal, normal));
+		}
+	};
+
+	std::unordered_map<faceptr, face_plane> facePlanes;
+	auto facePlane = [&](const faceptr& theFace) -> const face_plane& {
+		auto planeIt = facePlanes.find(theFace);
+		if (planeIt != facePlanes.end()) {
+			return planeIt->second;
+		}
+
+		// Newell's method, which stays accurate for faces with nearly collinear vertices
+		std::vector<edgeptr> faceEdges = faceToEdgeList(theFace);
+		const Point& origin = faceEdges[0]->origin()->data();
+		auto relative = [&](const Point& thePoint) {
+			return point<double>{ double(thePoint.x - origin.x), double(thePoint.y - origin.y), double(thePoint.z - origin.z) };
+		};
+
+		face_plane thePlane = { { 0, 0, 0 }, 0 };
+		point<double> vertexSum = { 0, 0, 0 };
+		for (const edgeptr& faceEdge : faceEdges) {
+			point<double> a = relative(faceEdge->origin()->data());
+			point<double> b = relative(faceEdge->destination()->data());
+			point<double> product = vectorProduct(a, b);
+			thePlane.normal = { thePlane.normal.x + product.x / 2, thePlane.normal.y + product.y / 2, thePlane.normal.z + product.z / 2 };
+			vertexSum = { vertexSum.x + a.x, vertexSum.y + a.y, vertexSum.z + a.z };
+		}
+
+		thePlane.offset = scalarProduct(thePlane.normal, vertexSum) / double(faceEdges.size()) + scalarProduct(thePlane.normal, toDouble(origin));
+		return facePlanes[theFace] = thePlane;
+	};
+
+	// The faces are taken as seeds from the largest one down, ties broken by their lowest vertex,
+	// so that the clusters don't depend on the order in which the graph lists the faces. Only the
+	// faces created since the last merge are seeds, the other ones were merged as far as they
+	// could be then, but they can still join the clusters of the new faces.
+	struct seed_face {
+		double area;
+		point<double> lowestVertex;
+		faceptr theFace;
+
+		bool operator<(const seed_face& other) const {
+			if (area != other.area) {
+				return area > other.area;
+			}
+
+			return std::tie(lowestVertex.x, lowestVertex.y, lowestVertex.z) < std::tie(other.lowestVertex.x, other.lowestVertex.y, other.lowestVertex.z);
+		}
+	};
+
+	std::vector<seed_face> seedFaces;
+	std::unordered_set<faceptr> seededFaces;
+	for (const faceptr& unmergedFace : m_unmergedFaces) {
+		if (!unmergedFace->outerComponent() || !seededFaces.insert(unmergedFace).second) {
+			continue;
+		}
+
+		const face_plane& thePlane = facePlane(unmergedFace);
+		seed_face seed = { std::sqrt(scalarProduct(thePlane.normal, thePlane.normal)), {}, unmergedFace };
+		std::vector<edgeptr> faceEdges = faceToEdgeList(unmergedFace);
+		seed.lowestVertex = toDouble(faceEdges[0]->origin()->data());
+		for (const edgeptr& faceEdge : faceEdges) {
+			point<double> faceVertex = toDouble(faceEdge->origin()->data());
+			if (std::tie(faceVertex.x, faceVertex.y, faceVertex.z) < std::tie(seed.lowestVertex.x, seed.lowestVertex.y, seed.lowestVertex.z)) {
+				seed.lowestVertex = faceVertex;
+			}
+		}
+
+		seedFaces.push_back(seed);
+	}
+
+	m_unmergedFaces.clear();
+	std::sort(seedFaces.begin(), seedFaces.end());
+
+	// Each cluster grows from its seed over the neighboring faces whose vertices all lie within
+	// the tolerance of the plane of the cluster so far, and is then joined into a single face
+	std::unordered_set<faceptr> clusteredFaces;
+	std::vector<faceptr> mergedFaces;
+	for (const seed_face& seed : seedFaces) {
+		if (!clusteredFaces.insert(seed.theFace).second) {
+			continue;
+		}
+
+		face_plane clusterPlane = facePlane(seed.theFace);
+		std::vector<faceptr> cluster = { seed.theFace };
+		std::unordered_set<faceptr> clusterSet = { seed.theFace };
+		for (size_t k = 0; k < cluster.size(); k++) {
+			for (const edgeptr& faceEdge : faceToEdgeList(cluster[k])) {
+				faceptr neighborFace = faceEdge->twin()->incidentFace();
+				if (clusteredFaces.count(neighborFace)) {
+					continue;
+				}
+
+				bool isClose = true;
+				for (const edgeptr& neighborEdge : faceToEdgeList(neighborFace)) {
+					isClose &= std::abs(clusterPlane.distance(toDouble(neighborEdge->origin()->data()))) <= m_options.coplanarityTolerance;
+				}
+
+				if (isClose) {
+					const face_plane& neighborPlane = facePlane(neighborFace);
+					clusterPlane.normal = { clusterPlane.normal.x + neighborPlane.normal.x, clusterPlane.normal.y + neighborPlane.normal.y, clusterPlane.normal.z + neighborPlane.normal.z };
+					clusterPlane.offset += neighborPlane.offset;
+					clusteredFaces.insert(neighborFace);
+					clusterSet.insert(neighborFace);
+					cluster.push_back(neighborFace);
+				}
+			}
+		}
+
+		if (cluster.size() == 1) {
+			continue;
+		}
+
+		// joinFaces needs the cluster to be bounded by a single simple cycle, which a cluster
+		// wrapped around a face that was left out of it isn't. Such a cluster is left as it is.
+		size_t borderLength = 0;
+		edgeptr startEdge;
+		for (const faceptr& clusterFace : cluster) {
+			for (const edgeptr& faceEdge : faceToEdgeList(clusterFace)) {
+				if (!clusterSet.count(faceEdge->twin()->incidentFace())) {
+					borderLength++;
+					startEdge = faceEdge;
+				}
+			}
+		}
+
+		std::unordered_set<vertexptr> borderVertices;
+		edgeptr borderEdge = startEdge;
+		do {
+			if (!borderVertices.insert(borderEdge->origin()).second) {
+				break;
+			}
+
+			borderEdge = borderEdge->next();
+			while (clusterSet.count(borderEdge->twin()->incidentFace())) {
+				borderEdge = borderEdge->twin()->next();
+			}
+		} while (borderEdge != startEdge);
+
+		if (borderVertices.size() != borderLength) {
+			continue;
+		}
+
+		graph_snapshot snapshot = beginChange(cluster);
+		join_faces_result<Point> joinResult = joinFaces(cluster);
+		endChange(snapshot, { joinResult.newFace });
+		count(&convex_hull_statistics::facesMerged, cluster.size() - 1);
+		mergedFaces.push_back(joinResult.newFace);
+
+		// The vertices of the removed edges are gone, keep the peak vertex on the graph
+		if (!m_peakVertex->incidentEdge()) {
+			m_peakVertex = joinResult.borderEdges[0]->origin();
+		}
+	}
+
+	// Returns true if the face has more than the given number of edges
+	auto hasMoreEdgesThan = [](const faceptr& theFace, size_t edgeCount) {
+		edgeptr walkingEdge = theFace->outerComponent();
+		for (size_t i = 0; i < edgeCount; i++) {
+			walkingEdge = walkingEdge->next();
+			if (walkingEdge == theFace->outerComponent()) {
+				return false;
+			}
+		}
+
+		return true;
+	};
+
+	// A border vertex may have been left between only two faces. It's removed unless it's farther
+	// than the tolerance from the line through its neighbors, as that would change the shape, or
+	// one of the faces is a triangle.
+	for (const faceptr& mergedFace : mergedFaces) {
+		if (!mergedFace->outerComponent()) {
+			continue;
+		}
+
+		for (const edgeptr& faceEdge : faceToEdgeList(mergedFace)) {
+			// Skip edges removed along with an earlier vertex
+			if (!faceEdge->origin()) {
+				continue;
+			}
+
+			vertexptr endpoint = faceEdge->origin();
+			edgeptr outEdge = endpoint->incidentEdge();
+			if (outEdge->twin()->next()->twin()->next() != outEdge) {
+				continue;
+			}
+
+			if (!hasMoreEdgesThan(outEdge->incidentFace(), 3) || !hasMoreEdgesThan(outEdge->twin()->incidentFace(), 3)) {
+				continue;
+			}
+
+			point<double> a = toDouble(outEdge->destination()->data());
+			point<double> lineVector = toDouble(outEdge->twin()->next()->destination()->data()) - a;
+			point<double> normalVector = vectorProduct(lineVector, toDouble(endpoint->data()) - a);
+			if (std::sqrt(scalarProduct(normalVector, normalVector) / scalarProduct(lineVector, lineVector)) <= m_options.coplanarityTolerance) {
+				if (m_peakVertex == endpoint) {
+					m_peakVertex = outEdge->destination();
+				}
+
+				removeRedundantVertexTracked(endpoint);
+				count(&convex_hull_statistics::redundantVerticesRemoved);
+			}
+		}
+	}
+
+	notify(callback, convex_hull_update::afterRemoveRedundantVertices);
+}
+
+/*
+ * Computes the convex hull of the points of a point source, such as a std::vector or one of the
+ * views from pointsource.h. The points are read in place, only the hull vertices are copied.
+ */
+template<class Source, class Callback>
+std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>> computeConvexHull3D(const Source& points, const convex_hull_options& options, Callback callback) {
+	incremental_convex_hull<point_source_element_t<Source>> hull(options);
+	hull.insert(points, callback);
+	return hull.vertex();
+}
+
+/*
+ * Computes the convex hull, and sets isPartial if it was stopped by the cancellation token or the
+ * deadline of the options before all points were added. A partial hull is the valid hull of the
+ * points added so far.
+ */
+template<class Source>
+std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>> computeConvexHull3D(const Source& points, const convex_hull_options& options, bool& isPartial) {
+	incremental_convex_hull<point_source_element_t<Source>> hull(options);
+	hull.insert(points);
+	isPartial = hull.isPartial();
+	return hull.vertex();
+}
+
+/*
+ * Computes the convex hull with the given execution policy instead of the one in the options.
+ */
+template<class Source>
+std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>> computeConvexHull3D(
+	const execution_policy& execution,
+	const Source& points,
+	const convex_hull_options& options = convex_hull_options())
+{
+	convex_hull_options policyOptions = options;
+	policyOptions.execution = execution;
+	return computeConvexHull3D(points, policyOptions);
+}
+
+/*
+ * Computes the convex hull using the scratch containers of the given workspace, see hull_workspace.
+ */
+template<class Source>
+std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>> computeConvexHull3D(
+	hull_workspace<point_source_element_t<Source>>& workspace,
+	const Source& points,
+	const convex_hull_options& options = convex_hull_options())
+{
+	incremental_convex_hull<point_source_element_t<Source>> hull(options, workspace);
+	hull.insert(points);
+	return hull.vertex();
+}
+
+/*
+ * Computes the convex hull and stores the counts of the work done in the given statistics, see
+ * convex_hull_statistics, whether or not the options collect them. A callback taking the
+ * statistics as a third argument also receives the counts so far with every update.
+ */
+template<class Source, class Callback>
+std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>> computeConvexHull3D(const Source& points, const convex_hull_options& options, convex_hull_statistics& statistics, Callback callback) {
+	convex_hull_options countingOptions = options;
+	countingOptions.collectStatistics = true;
+	incremental_convex_hull<point_source_element_t<Source>> hull(countingOptions);
+	hull.insert(points, callback);
+	statistics = hull.statistics();
+	return hull.vertex();
+}
+
+template<class Source>
+std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>> computeConvexHull3D(const Source& points, const convex_hull_options& options, convex_hull_statistics& statistics) {
+	return computeConvexHull3D(points, options, statistics, [](convex_hull_update, const std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>>&) {});
+}
+
+template<class Source>
+std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>> computeConvexHull3D(const Source& points, const convex_hull_options& options) {
+	return computeConvexHull3D(points, options, [](convex_hull_update, const std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>>&) {});
+}
+
+template<class Source, class Callback>
+std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>> computeConvexHull3D(const Source& points, Callback callback) {
+	return computeConvexHull3D(points, convex_hull_options(), callback);
+}
+
+template<class Source>
+std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>> computeConvexHull3D(const Source& points) {
+	return computeConvexHull3D(points, [](convex_hull_update, const std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>>&) {});
 }
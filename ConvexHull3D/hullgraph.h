@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <vector>
+#include <utility>
 #include <unordered_set>
 
 namespace hullgraph {
@@ -21,6 +24,185 @@ namespace hullgraph {
 	template<class T>
 	struct hullgraph_implementations;
 
+	class object_pool;
+
+	/*
+	 * The pool the graph functions called on this thread take new vertices, edges and faces
+	 * from, null for the heap. It's also the only pool this thread takes any memory from. Set it
+	 * with a pool_scope.
+	 */
+	inline std::shared_ptr<object_pool>& currentObjectPool() {
+		thread_local std::shared_ptr<object_pool> pool;
+		return pool;
+	}
+
+	/*
+	 * Keeps the memory of freed objects and hands it out again for objects of the same size, so
+	 * that a program which keeps building and destroying graphs of about the same size stops
+	 * allocating once it has done it a few times. The memory is only released when the pool and
+	 * all objects allocated from it are gone.
+	 * Only the thread which has the pool in its pool_scope takes memory from it, other threads
+	 * allocating from the pool get memory from the heap. Blocks can be freed on any thread: they go
+	 * onto a lock-free stack for their size, and the allocating thread takes the whole stack at
+	 * once when its own list runs out, so no thread ever waits for another.
+	 */
+	class object_pool {
+		struct free_block {
+			free_block* next;
+		};
+
+		struct size_class {
+			std::atomic<size_t> size{ 0 };
+			std::atomic<free_block*> freedBlocks{ nullptr };
+
+			// Only touched by the allocating thread
+			free_block* availableBlocks = nullptr;
+		};
+
+		// Objects of other sizes come from the heap, the graph and the workspace only use a few
+		static constexpr size_t maxSizeClasses = 16;
+		size_class m_sizeClasses[maxSizeClasses];
+
+		size_class* findSizeClass(size_t size) {
+			for (size_class& sizeClass : m_sizeClasses) {
+				size_t classSize = sizeClass.size.load(std::memory_order_acquire);
+				if (classSize == size) {
+					return &sizeClass;
+				}
+				if (classSize == 0) {
+					break;
+				}
+			}
+
+			return nullptr;
+		}
+
+		static void freeList(free_block* block) {
+			while (block) {
+				free_block* next = block->next;
+				::operator delete(block);
+				block = next;
+			}
+		}
+
+	public:
+		object_pool() = default;
+		object_pool(const object_pool&) = delete;
+		object_pool& operator=(const object_pool&) = delete;
+
+		~object_pool() {
+			for (size_class& sizeClass : m_sizeClasses) {
+				freeList(sizeClass.availableBlocks);
+				freeList(sizeClass.freedBlocks.load(std::memory_order_acquire));
+			}
+		}
+
+		void* allocate(size_t size) {
+			size = std::max(size, sizeof(free_block));
+			if (currentObjectPool().get() != this) {
+				return ::operator new(size);
+			}
+
+			size_class* sizeClass = findSizeClass(size);
+			if (!sizeClass) {
+				// Only the allocating thread adds size classes, before any block of the size exists
+				for (size_class& unusedClass : m_sizeClasses) {
+					if (unusedClass.size.load(std::memory_order_relaxed) == 0) {
+						unusedClass.size.store(size, std::memory_order_release);
+						break;
+					}
+				}
+
+				return ::operator new(size);
+			}
+
+			if (!sizeClass->availableBlocks) {
+				sizeClass->availableBlocks = sizeClass->freedBlocks.exchange(nullptr, std::memory_order_acquire);
+			}
+
+			free_block* block = sizeClass->availableBlocks;
+			if (!block) {
+				return ::operator new(size);
+			}
+
+			sizeClass->availableBlocks = block->next;
+			return block;
+		}
+
+		void deallocate(void* block, size_t size) {
+			size_class* sizeClass = findSizeClass(std::max(size, sizeof(free_block)));
+			if (!sizeClass) {
+				::operator delete(block);
+				return;
+			}
+
+			free_block* freedBlock = static_cast<free_block*>(block);
+			freedBlock->next = sizeClass->freedBlocks.load(std::memory_order_relaxed);
+			while (!sizeClass->freedBlocks.compare_exchange_weak(freedBlock->next, freedBlock, std::memory_order_release, std::memory_order_relaxed)) {}
+		}
+	};
+
+	/*
+	 * An allocator taking its memory from an object pool, or from the heap if it has none. The
+	 * pool is kept alive by the allocator, and so by every object and container using it.
+	 */
+	template<class U>
+	struct pool_allocator {
+		using value_type = U;
+
+		std::shared_ptr<object_pool> pool;
+
+		pool_allocator(std::shared_ptr<object_pool> pool = nullptr) noexcept : pool(std::move(pool)) {}
+
+		template<class V>
+		pool_allocator(const pool_allocator<V>& other) noexcept : pool(other.pool) {}
+
+		U* allocate(size_t count) {
+			if (!pool) {
+				return static_cast<U*>(::operator new(count * sizeof(U)));
+			}
+
+			return static_cast<U*>(pool->allocate(count * sizeof(U)));
+		}
+
+		void deallocate(U* block, size_t count) noexcept {
+			if (!pool) {
+				::operator delete(block);
+				return;
+			}
+
+			pool->deallocate(block, count * sizeof(U));
+		}
+
+		template<class V>
+		bool operator==(const pool_allocator<V>& other) const noexcept {
+			return pool == other.pool;
+		}
+
+		template<class V>
+		bool operator!=(const pool_allocator<V>& other) const noexcept {
+			return pool != other.pool;
+		}
+	};
+
+	/*
+	 * Makes the graph functions called on this thread take their objects from the given pool
+	 * (or from the heap if it's null) until the scope ends.
+	 */
+	class pool_scope {
+		std::shared_ptr<object_pool> m_previousPool;
+
+	public:
+		explicit pool_scope(std::shared_ptr<object_pool> pool) : m_previousPool(std::exchange(currentObjectPool(), std::move(pool))) {}
+
+		pool_scope(const pool_scope&) = delete;
+		pool_scope& operator=(const pool_scope&) = delete;
+
+		~pool_scope() {
+			currentObjectPool() = std::move(m_previousPool);
+		}
+	};
+
 	template<class T>
 	class edge {
 		std::shared_ptr<vertex<T>> m_origin;
@@ -123,7 +305,7 @@ namespace hullgraph {
 	 */
 	template<class T>
 	std::shared_ptr<face<T>> makePolygon(const std::vector<T>& data) {
-		return hullgraph_implementations<T>::makePolygon(data);
+		return hullgraph_implementations<T>::makePolygon(data.data(), data.size());
 	}
 
 	/*
@@ -131,58 +313,79 @@ namespace hullgraph {
 	 */
 	template<class T>
 	std::shared_ptr<face<T>> makeTriangle(const T& dataA, const T& dataB, const T& dataC) {
-		return makePolygon(std::vector<T>{ dataA, dataB, dataC });
+		const T data[3] = { dataA, dataB, dataC };
+		return hullgraph_implementations<T>::makePolygon(data, 3);
 	}
 
 	/*
-	 * Returns the list of all half-edges of the given face, in normal order, starting
-	 * from the face's outerComponent() edge.
+	 * Stores the list of all half-edges of the given face, in normal order, starting from the
+	 * face's outerComponent() edge, in the given vector. Its memory is kept between calls.
 	 */
 	template<class T>
-	std::vector<std::shared_ptr<edge<T>>> faceToEdgeList(const std::shared_ptr<face<T>>& theFace) {
+	void faceToEdgeList(const std::shared_ptr<face<T>>& theFace, std::vector<std::shared_ptr<edge<T>>>& edges) {
+		edges.clear();
 		if (!theFace) {
-			return {};
+			return;
 		}
 
-		std::vector<std::shared_ptr<edge<T>>> edges;
 		auto startEdge = theFace->outerComponent();
 		auto currEdge = startEdge;
 
 		do {
 			if (!currEdge) {
-				return {};
+				edges.clear();
+				return;
 			}
 
 			edges.push_back(currEdge);
 			currEdge = currEdge->next();
 		} while (currEdge != startEdge);
+	}
 
+	/*
+	 * Returns the list of all half-edges of the given face, in normal order, starting
+	 * from the face's outerComponent() edge.
+	 */
+	template<class T>
+	std::vector<std::shared_ptr<edge<T>>> faceToEdgeList(const std::shared_ptr<face<T>>& theFace) {
+		std::vector<std::shared_ptr<edge<T>>> edges;
+		faceToEdgeList(theFace, edges);
 		return edges;
 	}
 
 	/*
-	 * Returns the list of all half-edges exiting the given vertex, in normal order, starting
-	 * from the vertex's incidentEdge().
+	 * Stores the list of all half-edges exiting the given vertex, in normal order, starting from
+	 * the vertex's incidentEdge(), in the given vector. Its memory is kept between calls.
 	 */
 	template<class T>
-	std::vector<std::shared_ptr<edge<T>>> adjacentEdges(const std::shared_ptr<vertex<T>>& theVertex) {
+	void adjacentEdges(const std::shared_ptr<vertex<T>>& theVertex, std::vector<std::shared_ptr<edge<T>>>& edges) {
+		edges.clear();
 		if (!theVertex) {
-			return {};
+			return;
 		}
 
-		std::vector<std::shared_ptr<edge<T>>> edges;
 		auto startEdge = theVertex->incidentEdge();
 		auto currEdge = startEdge;
 
 		do {
 			if (!currEdge) {
-				return {};
+				edges.clear();
+				return;
 			}
 
 			edges.push_back(currEdge);
 			currEdge = currEdge->prev()->twin();
 		} while (currEdge != startEdge);
+	}
 
+	/*
+	 * Returns the list of all half-edges exiting the given vertex, in normal order, starting
+	 * from the vertex's incidentEdge().
+	 */
+	template<class T>
+	std::vector<std::shared_ptr<edge<T>>> adjacentEdges(const std::shared_ptr<vertex<T>>& theVertex) {
+		std::vector<std::shared_ptr<edge<T>>> edges;
+		adjacentEdges(theVertex, edges);
 		return edges;
 	}
 
@@ -216,7 +419,18 @@ namespace hullgraph {
 	 */
 	template<class T>
 	join_faces_result<T> joinFaces(const std::vector<std::shared_ptr<face<T>>>& faces) {
-		return hullgraph_implementations<T>::joinFaces(faces);
+		join_faces_result<T> result;
+		hullgraph_implementations<T>::joinFaces(faces, result);
+		return result;
+	}
+
+	/*
+	 * Same as joinFaces above, storing the result in the given struct, whose vectors keep their
+	 * memory between calls.
+	 */
+	template<class T>
+	void joinFaces(const std::vector<std::shared_ptr<face<T>>>& faces, join_faces_result<T>& result) {
+		hullgraph_implementations<T>::joinFaces(faces, result);
 	}
 
 	/*
@@ -229,6 +443,30 @@ namespace hullgraph {
 		return hullgraph_implementations<T>::removeRedundantVertex(theVertex);
 	}
 
+	/*
+	 * Connects the origins of two non-consecutive half-edges of the same face with a new edge,
+	 * splitting the face in two. Returns the new half-edge going from the origin of edgeB to the
+	 * origin of edgeA. Its incident face is the one containing edgeA, the other one contains edgeB.
+	 */
+	template<class T>
+	std::shared_ptr<edge<T>> splitFace(const std::shared_ptr<edge<T>>& edgeA, const std::shared_ptr<edge<T>>& edgeB) {
+		return hullgraph_implementations<T>::splitFace(edgeA, edgeB);
+	}
+
+	/*
+	 * Fills the hole left by a face of one graph with the rest of another graph, which has a face
+	 * bounded by the same cycle of points going the other way. holeEdge is a half-edge of the face
+	 * of the first graph, and patchEdge the half-edge of the face of the second graph between the
+	 * same two points, in the opposite direction. The half-edges of the second graph around its
+	 * face become the twins of those of the first graph around its face, and take over the border
+	 * vertices of the first graph. Both faces, their half-edges and the border vertices of the
+	 * second graph are invalidated. The behavior is undefined if the borders don't match.
+	 */
+	template<class T>
+	void spliceFaces(const std::shared_ptr<edge<T>>& holeEdge, const std::shared_ptr<edge<T>>& patchEdge) {
+		hullgraph_implementations<T>::spliceFaces(holeEdge, patchEdge);
+	}
+
 	/*
 	 * Returns the list of all edges reachable from the given vertex.
 	 */
@@ -255,6 +493,37 @@ namespace hullgraph {
 		return edgesQueue;
 	}
 
+	/*
+	 * Invalidates all vertices, edges and faces reachable from the given vertex. The objects of a
+	 * graph keep each other alive, so a graph which is no longer needed has to be destroyed to
+	 * free its memory. Pointers to its objects held elsewhere stay safe to use, but invalidated.
+	 */
+	template<class T>
+	void destroyGraph(const std::shared_ptr<vertex<T>>& initialVertex) {
+		if (!initialVertex || !initialVertex->incidentEdge()) {
+			return;
+		}
+
+		// An edge is invalidated the first time it comes up, so invalidated edges were already
+		// visited. The stack keeps its memory, destroying a graph doesn't allocate.
+		thread_local std::vector<std::shared_ptr<edge<T>>> edgesStack;
+		edgesStack.push_back(initialVertex->incidentEdge());
+		while (edgesStack.size()) {
+			auto currEdge = std::move(edgesStack.back());
+			edgesStack.pop_back();
+			if (!currEdge->origin()) {
+				continue;
+			}
+
+			edgesStack.push_back(currEdge->twin());
+			edgesStack.push_back(currEdge->next());
+			edgesStack.push_back(currEdge->prev());
+			currEdge->origin()->invalidate();
+			currEdge->incidentFace()->invalidate();
+			currEdge->invalidate();
+		}
+	}
+
 	/*
 	 * Returns whether the given vertex has degree exactly two.
 	 */
@@ -275,116 +544,134 @@ namespace hullgraph {
 	template<class T>
 	struct hullgraph_implementations {
 
-		static std::shared_ptr<face<T>> makePolygon(const std::vector<T>& data) {
-			size_t degree = data.size();
-
-			if (degree < 3) {
-				return nullptr;
+		/*
+		 * Makes a new vertex, edge or face, from the pool of the calling thread if it has one.
+		 */
+		template<class Object>
+		static std::shared_ptr<Object> makeObject() {
+			const std::shared_ptr<object_pool>& pool = currentObjectPool();
+			if (pool) {
+				return std::allocate_shared<Object>(pool_allocator<Object>(pool));
 			}
 
-			auto innerFace = std::make_shared<face<T>>();
-			auto outerFace = std::make_shared<face<T>>();
+			return std::make_shared<Object>();
+		}
 
-			if (!innerFace || !outerFace) {
+		static std::shared_ptr<face<T>> makePolygon(const T* data, size_t degree) {
+			if (degree < 3) {
 				return nullptr;
 			}
 
-			std::vector<std::shared_ptr<vertex<T>>> vertices(degree);
-			std::vector<std::shared_ptr<edge<T>>> forwardEdges(degree);
-			std::vector<std::shared_ptr<edge<T>>> backwardEdges(degree);
+			auto innerFace = makeObject<face<T>>();
+			auto outerFace = makeObject<face<T>>();
 
+			// Each forward edge goes from the i-th vertex to the next one, and is linked to the
+			// previous forward edge as soon as it exists. The backward edges go the other way.
+			std::shared_ptr<vertex<T>> firstVertex;
+			std::shared_ptr<edge<T>> firstForwardEdge, firstBackwardEdge, prevForwardEdge, prevBackwardEdge;
 			for (size_t i = 0; i < degree; i++) {
-				vertices[i] = std::make_shared<vertex<T>>();
-				forwardEdges[i] = std::make_shared<edge<T>>();
-				backwardEdges[i] = std::make_shared<edge<T>>();
-				if (!vertices[i] || !forwardEdges[i] || !backwardEdges[i]) {
-					return nullptr;
+				auto currVertex = makeObject<vertex<T>>();
+				auto forwardEdge = makeObject<edge<T>>();
+				auto backwardEdge = makeObject<edge<T>>();
+
+				currVertex->m_data = data[i];
+				currVertex->m_incidentEdge = forwardEdge;
+
+				forwardEdge->m_origin = currVertex;
+				forwardEdge->m_twin = backwardEdge;
+				backwardEdge->m_twin = forwardEdge;
+				forwardEdge->m_incidentFace = innerFace;
+				backwardEdge->m_incidentFace = outerFace;
+
+				if (prevForwardEdge) {
+					prevBackwardEdge->m_origin = currVertex;
+					prevForwardEdge->m_next = forwardEdge;
+					forwardEdge->m_prev = prevForwardEdge;
+					backwardEdge->m_next = prevBackwardEdge;
+					prevBackwardEdge->m_prev = backwardEdge;
+				}
+				else {
+					firstVertex = currVertex;
+					firstForwardEdge = forwardEdge;
+					firstBackwardEdge = backwardEdge;
 				}
-			}
-
-			for (size_t i = 0; i < degree; i++) {
-				size_t iPrev = i == 0 ? degree - 1 : i - 1;
-				size_t iNext = i == degree - 1 ? 0 : i + 1;
-
-				vertices[i]->m_data = data[i];
-				vertices[i]->m_incidentEdge = forwardEdges[i];
-
-				forwardEdges[i]->m_origin = vertices[i];
-				backwardEdges[i]->m_origin = vertices[iNext];
-
-				forwardEdges[i]->m_twin = backwardEdges[i];
-				backwardEdges[i]->m_twin = forwardEdges[i];
-
-				forwardEdges[i]->m_next = forwardEdges[iNext];
-				backwardEdges[i]->m_next = backwardEdges[iPrev];
-
-				forwardEdges[i]->m_prev = forwardEdges[iPrev];
-				backwardEdges[i]->m_prev = backwardEdges[iNext];
 
-				forwardEdges[i]->m_incidentFace = innerFace;
-				backwardEdges[i]->m_incidentFace = outerFace;
+				prevForwardEdge = forwardEdge;
+				prevBackwardEdge = backwardEdge;
 			}
 
-			innerFace->m_outerComponent = forwardEdges[0];
-			outerFace->m_outerComponent = backwardEdges[0];
+			prevBackwardEdge->m_origin = firstVertex;
+			prevForwardEdge->m_next = firstForwardEdge;
+			firstForwardEdge->m_prev = prevForwardEdge;
+			firstBackwardEdge->m_next = prevBackwardEdge;
+			prevBackwardEdge->m_prev = firstBackwardEdge;
+
+			innerFace->m_outerComponent = firstForwardEdge;
+			outerFace->m_outerComponent = firstBackwardEdge;
 
 			return innerFace;
 		}
 
 		static std::shared_ptr<vertex<T>> inscribeVertex(const std::shared_ptr<face<T>>& oldFace, const T& data) {
-			auto edges = faceToEdgeList(oldFace);
-			size_t degree = edges.size();
-
-			if (!degree) {
-				return nullptr;
-			}
-
-			auto newVertex = std::make_shared<vertex<T>>();
-			if (!newVertex) {
+			auto startEdge = oldFace ? oldFace->outerComponent() : nullptr;
+			if (!startEdge) {
 				return nullptr;
 			}
 
-			std::vector<std::shared_ptr<edge<T>>> newEdgesFrom(degree);
-			std::vector<std::shared_ptr<edge<T>>> newEdgesTo(degree);
-			std::vector<std::shared_ptr<face<T>>> newFaces(degree);
-
-			for (size_t i = 0; i < degree; i++) {
-				newEdgesFrom[i] = std::make_shared<edge<T>>();
-				newEdgesTo[i] = std::make_shared<edge<T>>();
-				newFaces[i] = std::make_shared<face<T>>();
+			auto newVertex = makeObject<vertex<T>>();
 
-				if (!newEdgesFrom[i] || !newEdgesTo[i] || !newFaces[i]) {
-					return nullptr;
+			// The i-th new face is made of the i-th old edge, the edge from the new vertex to its
+			// origin and the edge from its destination back to the new vertex. Each new face is
+			// linked to the previous one as soon as it exists, the next pointer of an old edge is
+			// read before it's changed.
+			std::shared_ptr<edge<T>> firstEdgeFrom, firstEdgeTo, prevEdge, prevEdgeFrom;
+			std::shared_ptr<face<T>> prevFace;
+			auto currEdge = startEdge;
+			do {
+				auto nextEdge = currEdge->m_next;
+				auto newEdgeFrom = makeObject<edge<T>>();
+				auto newEdgeTo = makeObject<edge<T>>();
+				auto newFace = makeObject<face<T>>();
+
+				newEdgeFrom->m_twin = newEdgeTo;
+				newEdgeTo->m_twin = newEdgeFrom;
+
+				newEdgeFrom->m_origin = newVertex;
+				newEdgeTo->m_origin = currEdge->m_origin;
+
+				newEdgeFrom->m_next = currEdge;
+				newEdgeFrom->m_incidentFace = newFace;
+				newFace->m_outerComponent = newEdgeFrom;
+
+				currEdge->m_prev = newEdgeFrom;
+				currEdge->m_incidentFace = newFace;
+
+				if (prevEdge) {
+					newEdgeTo->m_next = prevEdgeFrom;
+					newEdgeTo->m_prev = prevEdge;
+					newEdgeTo->m_incidentFace = prevFace;
+					prevEdgeFrom->m_prev = newEdgeTo;
+					prevEdge->m_next = newEdgeTo;
+				}
+				else {
+					firstEdgeFrom = newEdgeFrom;
+					firstEdgeTo = newEdgeTo;
 				}
-			}
-
-			for (size_t i = 0; i < degree; i++) {
-				size_t iPrev = i == 0 ? degree - 1 : i - 1;
-				size_t iNext = i == degree - 1 ? 0 : i + 1;
-
-				newEdgesFrom[i]->m_twin = newEdgesTo[i];
-				newEdgesTo[i]->m_twin = newEdgesFrom[i];
-
-				newEdgesFrom[i]->m_origin = newVertex;
-				newEdgesTo[i]->m_origin = edges[i]->m_origin;
-
-				newEdgesFrom[i]->m_next = edges[i];
-				newEdgesFrom[i]->m_prev = newEdgesTo[iNext];
-				newEdgesTo[i]->m_next = newEdgesFrom[iPrev];
-				newEdgesTo[i]->m_prev = edges[iPrev];
-
-				newEdgesFrom[i]->m_incidentFace = newFaces[i];
-				newEdgesTo[i]->m_incidentFace = newFaces[iPrev];
 
-				newFaces[i]->m_outerComponent = newEdgesFrom[i];
+				prevEdge = currEdge;
+				prevEdgeFrom = newEdgeFrom;
+				prevFace = newFace;
+				currEdge = nextEdge;
+			} while (currEdge != startEdge);
 
-				edges[i]->m_next = newEdgesTo[iNext];
-				edges[i]->m_prev = newEdgesFrom[i];
-				edges[i]->m_incidentFace = newFaces[i];
-			}
+			firstEdgeTo->m_next = prevEdgeFrom;
+			firstEdgeTo->m_prev = prevEdge;
+			firstEdgeTo->m_incidentFace = prevFace;
+			prevEdgeFrom->m_prev = firstEdgeTo;
+			prevEdge->m_next = firstEdgeTo;
 
 			newVertex->m_data = data;
-			newVertex->m_incidentEdge = newEdgesFrom[0];
+			newVertex->m_incidentEdge = firstEdgeFrom;
 
 			oldFace->invalidate();
 
@@ -392,12 +679,6 @@ namespace hullgraph {
 		}
 
 		static std::shared_ptr<face<T>> removeEdge(const std::shared_ptr<edge<T>>& halfEdge) {
-			auto newFace = std::make_shared<face<T>>();
-
-			if (!newFace) {
-				return nullptr;
-			}
-
 			auto u = halfEdge->origin();
 			auto v = halfEdge->destination();
 
@@ -419,17 +700,15 @@ namespace hullgraph {
 			auto upperFace = halfEdge->incidentFace();
 			auto lowerFace = twinEdge->incidentFace();
 
-			auto upperFaceEdges = faceToEdgeList(upperFace);
-			auto lowerFaceEdges = faceToEdgeList(lowerFace);
-
+			auto newFace = makeObject<face<T>>();
 			newFace->m_outerComponent = fromV;
 
-			for (const auto& upperFaceEdge : upperFaceEdges) {
-				upperFaceEdge->m_incidentFace = newFace;
-			}
-
-			for (const auto& lowerFaceEdge : lowerFaceEdges) {
-				lowerFaceEdge->m_incidentFace = newFace;
+			for (const auto& removedEdge : { halfEdge, twinEdge }) {
+				auto currEdge = removedEdge;
+				do {
+					currEdge->m_incidentFace = newFace;
+					currEdge = currEdge->m_next;
+				} while (currEdge != removedEdge);
 			}
 
 			fromU->m_prev = toU;
@@ -448,29 +727,40 @@ namespace hullgraph {
 			return newFace;
 		}
 
-		static join_faces_result<T> joinFaces(const std::vector<std::shared_ptr<face<T>>>& faces) {
-			join_faces_result<T> result;
-
-			result.newFace = std::make_shared<face<T>>();
+		static void joinFaces(const std::vector<std::shared_ptr<face<T>>>& faces, join_faces_result<T>& result) {
+			result.removedVertices.clear();
+			result.removedEdges.clear();
+			result.borderEdges.clear();
+			result.borderFaces.clear();
+			result.newFace = makeObject<face<T>>();
 
-			if (!faces.size() || !result.newFace) {
-				return result;
+			if (!faces.size()) {
+				return;
 			}
 
+			// Calls the function with each half-edge of the face, without copying the pointers
+			auto forEachEdge = [](const std::shared_ptr<face<T>>& facePtr, auto function) {
+				const std::shared_ptr<edge<T>>* edgePtr = &facePtr->m_outerComponent;
+				do {
+					function(*edgePtr);
+					edgePtr = &(*edgePtr)->m_next;
+				} while (*edgePtr != facePtr->m_outerComponent);
+			};
+
 			// Remove tags from all vertices and edges (both half-edges and twins)
 			for (const auto& facePtr : faces) {
-				for (const auto& edgePtr : faceToEdgeList(facePtr)) {
+				forEachEdge(facePtr, [](const std::shared_ptr<edge<T>>& edgePtr) {
 					edgePtr->m_tag = 0;
-					edgePtr->twin()->m_tag = 0;
-					edgePtr->origin()->m_tag = 0;
-				}
+					edgePtr->m_twin->m_tag = 0;
+					edgePtr->m_origin->m_tag = 0;
+				});
 			}
 
 			// Tag all half-edges
 			for (const auto& facePtr : faces) {
-				for (const auto& edgePtr : faceToEdgeList(facePtr)) {
+				forEachEdge(facePtr, [](const std::shared_ptr<edge<T>>& edgePtr) {
 					edgePtr->m_tag = 1;
-				}
+				});
 			}
 
 			// The half-edges whose twins are not tagged form the border of the new face
@@ -479,16 +769,13 @@ namespace hullgraph {
 
 			// Find a starting edge
 			for (const auto& facePtr : faces) {
-				bool found = false;
-				for (const auto& edgePtr : faceToEdgeList(facePtr)) {
-					if (edgePtr->twin()->m_tag == 0) {
+				forEachEdge(facePtr, [&](const std::shared_ptr<edge<T>>& edgePtr) {
+					if (!startEdge && edgePtr->m_twin->m_tag == 0) {
 						startEdge = edgePtr;
-						found = true;
-						break;
 					}
-				}
+				});
 
-				if (found) {
+				if (startEdge) {
 					break;
 				}
 			}
@@ -512,23 +799,21 @@ namespace hullgraph {
 				borderEdge->origin()->m_tag = 1;
 			}
 
-			std::unordered_set<std::shared_ptr<vertex<T>>> removedVerticesSet;
-
-			// Process all vertices and edges ready for removal
+			// Process all vertices and edges ready for removal. Removed vertices are tagged once
+			// they are listed, so that each of them is listed once.
 			for (const auto& facePtr : faces) {
-				for (const auto& edgePtr : faceToEdgeList(facePtr)) {
-					if (edgePtr->twin()->m_tag == 1) {
+				forEachEdge(facePtr, [&](const std::shared_ptr<edge<T>>& edgePtr) {
+					if (edgePtr->m_twin->m_tag == 1) {
 						result.removedEdges.push_back(edgePtr);
 					}
 
-					if (edgePtr->origin()->m_tag == 0) {
-						removedVerticesSet.insert(edgePtr->origin());
+					if (edgePtr->m_origin->m_tag == 0) {
+						edgePtr->m_origin->m_tag = 2;
+						result.removedVertices.push_back(edgePtr->m_origin);
 					}
-				}
+				});
 			}
 
-			result.removedVertices.assign(removedVerticesSet.begin(), removedVerticesSet.end());
-
 			// Invalidate removed objects
 			for (const auto& removedVertex : result.removedVertices) {
 				removedVertex->invalidate();
@@ -554,8 +839,93 @@ namespace hullgraph {
 				borderEdges[i]->m_next = borderEdges[iNext];
 				borderEdges[i]->m_prev = borderEdges[iPrev];
 			}
+		}
+
+		static std::shared_ptr<edge<T>> splitFace(const std::shared_ptr<edge<T>>& edgeA, const std::shared_ptr<edge<T>>& edgeB) {
+			auto newEdge = makeObject<edge<T>>();
+			auto twinEdge = makeObject<edge<T>>();
+			auto newFace = makeObject<face<T>>();
+
+			auto oldFace = edgeA->incidentFace();
+			auto prevEdgeA = edgeA->prev();
+			auto prevEdgeB = edgeB->prev();
+
+			newEdge->m_origin = edgeB->origin();
+			twinEdge->m_origin = edgeA->origin();
+
+			newEdge->m_twin = twinEdge;
+			twinEdge->m_twin = newEdge;
+
+			newEdge->m_next = edgeA;
+			newEdge->m_prev = prevEdgeB;
+			twinEdge->m_next = edgeB;
+			twinEdge->m_prev = prevEdgeA;
+
+			prevEdgeB->m_next = newEdge;
+			edgeA->m_prev = newEdge;
+			prevEdgeA->m_next = twinEdge;
+			edgeB->m_prev = twinEdge;
+
+			newEdge->m_incidentFace = oldFace;
+			oldFace->m_outerComponent = edgeA;
+
+			newFace->m_outerComponent = edgeB;
+			auto currEdge = edgeB;
+			do {
+				currEdge->m_incidentFace = newFace;
+				currEdge = currEdge->m_next;
+			} while (currEdge != edgeB);
+
+			return newEdge;
+		}
+
+		static void spliceFaces(const std::shared_ptr<edge<T>>& holeEdge, const std::shared_ptr<edge<T>>& patchEdge) {
+			auto holeFace = holeEdge->incidentFace();
+			auto patchFace = patchEdge->incidentFace();
+
+			// The i-th hole edge goes along the i-th patch edge the other way, the hole edges are
+			// walked forward and the patch edges backward
+			std::vector<std::shared_ptr<edge<T>>> holeEdges, patchEdges;
+			auto currHoleEdge = holeEdge;
+			auto currPatchEdge = patchEdge;
+			do {
+				holeEdges.push_back(currHoleEdge);
+				patchEdges.push_back(currPatchEdge);
+				currHoleEdge = currHoleEdge->m_next;
+				currPatchEdge = currPatchEdge->m_prev;
+			} while (currHoleEdge != holeEdge);
+
+			// The edges leaving a border vertex of the patch are moved over to the matching vertex
+			// of the hole, which is the origin of the i-th hole edge and the destination of the
+			// i-th patch edge
+			for (size_t i = 0; i < holeEdges.size(); i++) {
+				auto holeVertex = holeEdges[i]->m_origin;
+				auto patchVertex = patchEdges[i]->m_twin->m_origin;
+				auto startEdge = patchEdges[i]->m_twin;
+				auto currEdge = startEdge;
+				do {
+					currEdge->m_origin = holeVertex;
+					currEdge = currEdge->m_prev->m_twin;
+				} while (currEdge != startEdge);
+
+				holeVertex->m_incidentEdge = startEdge;
+				patchVertex->invalidate();
+			}
+
+			for (size_t i = 0; i < holeEdges.size(); i++) {
+				auto outerEdge = holeEdges[i]->m_twin;
+				auto innerEdge = patchEdges[i]->m_twin;
+				outerEdge->m_twin = innerEdge;
+				innerEdge->m_twin = outerEdge;
+			}
+
+			for (size_t i = 0; i < holeEdges.size(); i++) {
+				holeEdges[i]->invalidate();
+				patchEdges[i]->invalidate();
+			}
 
-			return result;
+			holeFace->invalidate();
+			patchFace->invalidate();
 		}
 
 		static std::shared_ptr<edge<T>> removeRedundantVertex(const std::shared_ptr<vertex<T>>& theVertex) {
@@ -569,12 +939,8 @@ namespace hullgraph {
 				return nullptr;
 			}
 
-			auto newEdge = std::make_shared<edge<T>>();
-			auto twinEdge = std::make_shared<edge<T>>();
-
-			if (!newEdge || !twinEdge) {
-				return nullptr;
-			}
+			auto newEdge = makeObject<edge<T>>();
+			auto twinEdge = makeObject<edge<T>>();
 
 			auto nextEdge1 = outEdge1->next();
 			auto nextEdge2 = outEdge2->next();
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "hull3d.h"
+
+#include <iterator>
+
+/*
+ * The coordinates of the points of another source, labeled with their index and without any
+ * other data they carry.
+ */
+template<class Source>
+struct index_labeled_point_source {
+	using F = decltype(point_source_element_t<Source>::x);
+
+	const Source& points;
+
+	size_t size() const {
+		return points.size();
+	}
+
+	labeled_point<F, size_t> operator[](size_t index) const {
+		const auto& thePoint = points[index];
+		return labeled_point<F, size_t>(thePoint.x, thePoint.y, thePoint.z, index);
+	}
+};
+
+/*
+ * A convex hull given by the indices of its vertices in the input.
+ */
+struct convex_hull_indices {
+	// The indices of the hull vertices, in increasing order
+	std::vector<size_t> vertices;
+
+	// Each face as the indices of its vertices, in the same order as the faces of computeConvexHull3D
+	std::vector<std::vector<size_t>> faces;
+};
+
+/*
+ * Computes the convex hull like computeConvexHull3D, but the engine only sees the coordinates of
+ * the points, and each vertex of the result is labeled with the index of its point in the input.
+ * Whatever else the points carry, such as the label of a labeled_point, is never copied, so
+ * callers with heavy payloads should join them to the result afterwards.
+ */
+template<class Source>
+std::shared_ptr<hullgraph::vertex<labeled_point<decltype(point_source_element_t<Source>::x), size_t>>> computeConvexHull3DIndexed(
+	const Source& points,
+	const convex_hull_options& options = convex_hull_options())
+{
+	return computeConvexHull3D(index_labeled_point_source<Source>{ points }, options);
+}
+
+/*
+ * Lists the vertices and faces of a hull computed by computeConvexHull3DIndexed, then destroys its
+ * graph. The edges of the graph are split into blocks listed in parallel as set by the execution
+ * policy, and the result doesn't depend on the number of threads.
+ */
+template<class F>
+convex_hull_indices extractHullIndices(
+	const std::shared_ptr<hullgraph::vertex<labeled_point<F, size_t>>>& hullVertex,
+	const execution_policy& execution = execution_policy())
+{
+	using namespace hullgraph;
+
+	convex_hull_indices result;
+	if (!hullVertex) {
+		return result;
+	}
+
+	// Each face is listed from its outer component, so no set of the faces already listed is needed
+	auto allEdges = exploreGraph(hullVertex);
+	execution_policy blockExecution = execution.forItems(allEdges.size(), 1 << 12);
+	std::vector<convex_hull_indices> blockResults(blockExecution.threadCount);
+	size_t blockCount = parallelBlocks(allEdges.size(), blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+		convex_hull_indices& blockResult = blockResults[blockIndex];
+		std::vector<std::shared_ptr<edge<labeled_point<F, size_t>>>> faceEdges;
+		for (size_t i = begin; i < end; i++) {
+			const auto& theEdge = allEdges[i];
+			blockResult.vertices.push_back(theEdge->origin()->data().label);
+			if (theEdge == theEdge->incidentFace()->outerComponent()) {
+				faceToEdgeList(theEdge->incidentFace(), faceEdges);
+				std::vector<size_t> faceIndices;
+				for (const auto& faceEdge : faceEdges) {
+					faceIndices.push_back(faceEdge->origin()->data().label);
+				}
+
+				blockResult.faces.push_back(std::move(faceIndices));
+			}
+		}
+
+		std::sort(blockResult.vertices.begin(), blockResult.vertices.end());
+		blockResult.vertices.erase(std::unique(blockResult.vertices.begin(), blockResult.vertices.end()), blockResult.vertices.end());
+	});
+
+	for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+		convex_hull_indices& blockResult = blockResults[blockIndex];
+		result.vertices.insert(result.vertices.end(), blockResult.vertices.begin(), blockResult.vertices.end());
+		std::move(blockResult.faces.begin(), blockResult.faces.end(), std::back_inserter(result.faces));
+	}
+
+	destroyGraph(hullVertex);
+	std::sort(result.vertices.begin(), result.vertices.end());
+	result.vertices.erase(std::unique(result.vertices.begin(), result.vertices.end()), result.vertices.end());
+	return result;
+}
+
+/*
+ * Computes the convex hull and returns it as indices into the input, see computeConvexHull3DIndexed.
+ * If the points are coplanar, the two sides of their polygon are the two faces, and if they are
+ * collinear, the result is empty.
+ */
+template<class Source>
+convex_hull_indices computeConvexHull3DIndices(const Source& points, const convex_hull_options& options = convex_hull_options()) {
+	return extractHullIndices(computeConvexHull3DIndexed(points, options), options.execution);
+}
+
+/*
+ * Computes the convex hull as indices into the input, using the scratch containers of the given workspace.
+ */
+template<class Source>
+convex_hull_indices computeConvexHull3DIndices(
+	hull_workspace<labeled_point<decltype(point_source_element_t<Source>::x), size_t>>& workspace,
+	const Source& points,
+	const convex_hull_options& options = convex_hull_options())
+{
+	return extractHullIndices(computeConvexHull3D(workspace, index_labeled_point_source<Source>{ points }, options), options.execution);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "hull3d.h"
+
+/*
+ * Computes the convex hull of the union of a hull computed with the given options and a list of
+ * points, taking over the graph of the hull. The hull is kept as it is and each point is located
+ * on it by walking over its faces from where the previous one was found, see hull_face_locator,
+ * so only the points outside of it are inserted. This is how hulls without a graph are merged:
+ * collinear points have a null graph, and their extremes (see incremental_convex_hull::vertices)
+ * are passed as the points. A null hull is the hull of the points alone.
+ */
+template<class Point>
+std::shared_ptr<hullgraph::vertex<Point>> mergeHulls(
+	const std::shared_ptr<hullgraph::vertex<Point>>& hullVertex,
+	const std::vector<Point>& points,
+	const convex_hull_options& options = convex_hull_options())
+{
+	incremental_convex_hull<Point> hull(options, hullVertex);
+	hull.insert(points);
+	return hull.vertex();
+}
+
+/*
+ * Computes the convex hull of the union of two hulls computed with the given options, taking over
+ * their graphs. The hull with more edges is kept as it is and the vertices of the other one are
+ * merged into it like a list of points, so no point inside of either hull is ever looked at again.
+ * A null graph is an empty hull, so collinear points, which have no graph, are merged with the
+ * overload taking a list of points instead.
+ */
+template<class Point>
+std::shared_ptr<hullgraph::vertex<Point>> mergeHulls(
+	const std::shared_ptr<hullgraph::vertex<Point>>& a,
+	const std::shared_ptr<hullgraph::vertex<Point>>& b,
+	const convex_hull_options& options = convex_hull_options())
+{
+	using namespace hullgraph;
+
+	std::vector<std::shared_ptr<edge<Point>>> edgesOfA = exploreGraph(a);
+	std::vector<std::shared_ptr<edge<Point>>> edgesOfB = exploreGraph(b);
+	bool keepsA = edgesOfA.size() >= edgesOfB.size();
+
+	std::vector<Point> addedVertices;
+	std::unordered_set<std::shared_ptr<vertex<Point>>> visitedVertices;
+	for (const auto& theEdge : keepsA ? edgesOfB : edgesOfA) {
+		if (visitedVertices.insert(theEdge->origin()).second) {
+			addedVertices.push_back(theEdge->origin()->data());
+		}
+	}
+
+	visitedVertices.clear();
+	edgesOfA.clear();
+	edgesOfB.clear();
+	destroyGraph(keepsA ? b : a);
+	return mergeHulls(keepsA ? a : b, addedVertices, options);
+}
+
+/*
+ * Computes the convex hull of the union of many hulls computed with the given options and a list
+ * of points, taking over the graphs of the hulls. The hulls are merged in pairs, each round in
+ * parallel as set by options.execution, until one is left, and the points are merged into it last.
+ * Collinear points have a null graph, so their extremes should be among the points. Returns null
+ * if there are no hulls and the points don't span the space.
+ */
+template<class Point>
+std::shared_ptr<hullgraph::vertex<Point>> mergeHulls(
+	std::vector<std::shared_ptr<hullgraph::vertex<Point>>> hulls,
+	const std::vector<Point>& points,
+	const convex_hull_options& options = convex_hull_options())
+{
+	if (hulls.empty()) {
+		return points.empty() ? nullptr : mergeHulls(std::shared_ptr<hullgraph::vertex<Point>>(), points, options);
+	}
+
+	while (hulls.size() > 1) {
+		size_t pairCount = hulls.size() / 2;
+
+		// While the threads are busy with other pairs, each pair is merged on one of them
+		convex_hull_options pairOptions = options;
+		if (pairCount > 1) {
+			pairOptions.execution = sequentialExecution();
+		}
+
+		std::vector<std::shared_ptr<hullgraph::vertex<Point>>> mergedHulls(pairCount);
+		parallelForEach(pairCount, options.execution.limitedTo(pairCount), [&](size_t, size_t pairIndex) {
+			mergedHulls[pairIndex] = mergeHulls(hulls[2 * pairIndex], hulls[2 * pairIndex + 1], pairOptions);
+		});
+
+		if (hulls.size() % 2) {
+			mergedHulls.push_back(hulls.back());
+		}
+		hulls.swap(mergedHulls);
+	}
+
+	return points.empty() ? hulls[0] : mergeHulls(hulls[0], points, options);
+}
+
+/*
+ * Computes the convex hull of the union of many hulls computed with the given options, see the
+ * overload taking a list of points. Returns null if there are no hulls.
+ */
+template<class Point>
+std::shared_ptr<hullgraph::vertex<Point>> mergeHulls(
+	std::vector<std::shared_ptr<hullgraph::vertex<Point>>> hulls,
+	const convex_hull_options& options = convex_hull_options())
+{
+	return mergeHulls(std::move(hulls), std::vector<Point>(), options);
+}
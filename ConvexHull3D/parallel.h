@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
+#include <functional>
+
+/*
+ * Returns the given thread count, or the number of hardware threads if it's zero.
+ */
+inline size_t resolveThreadCount(size_t threadCount) {
+	if (threadCount) {
+		return threadCount;
+	}
+
+	return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+/*
+ * How the parallel stages of a computation are run. Each stage is split into at most threadCount
+ * tasks, where zero means one per hardware thread and one means that everything runs on the
+ * calling thread. The tasks run on threads started for the stage, or on the caller's own thread
+ * pool if an executor is given. A thread count converts to a policy, so anything which takes a
+ * policy also takes a plain thread count. The default policy is sequential, so that a caller only
+ * gets threads by asking for them.
+ */
+struct execution_policy {
+	// Runs task(i) for every i in [0, taskCount), possibly in parallel, and returns once all of
+	// them have finished. The tasks never throw.
+	using executor_type = std::function<void(size_t taskCount, const std::function<void(size_t)>& task)>;
+
+	size_t threadCount = 1;
+	executor_type executor;
+
+	execution_policy(size_t threadCount = 1, executor_type executor = nullptr) : threadCount(threadCount), executor(std::move(executor)) {}
+
+	/*
+	 * Returns the same policy, with stages split into at most maxTasks tasks. Its thread count is
+	 * the exact number of tasks, never zero.
+	 */
+	execution_policy limitedTo(size_t maxTasks) const {
+		return execution_policy(std::max<size_t>(1, std::min(resolveThreadCount(threadCount), maxTasks)), executor);
+	}
+
+	/*
+	 * Returns the same policy, limited to one task per minBlockSize items, as threads only pay off
+	 * when each of them gets a sizable block. The default suits items which take a few arithmetic
+	 * operations each; a pass doing more work per item can use smaller blocks.
+	 */
+	execution_policy forItems(size_t itemCount, size_t minBlockSize = 1 << 14) const {
+		return limitedTo(itemCount / minBlockSize + 1);
+	}
+};
+
+/*
+ * Runs everything on the calling thread.
+ */
+inline execution_policy sequentialExecution() {
+	return execution_policy(1);
+}
+
+/*
+ * Runs each stage on the given number of threads, all hardware threads if it's zero.
+ */
+inline execution_policy parallelExecution(size_t threadCount = 0) {
+	return execution_policy(threadCount);
+}
+
+/*
+ * Runs each stage as taskCount tasks (one per hardware thread if it's zero) of the given executor,
+ * see execution_policy::executor_type.
+ */
+inline execution_policy poolExecution(execution_policy::executor_type executor, size_t taskCount = 0) {
+	return execution_policy(taskCount, std::move(executor));
+}
+
+/*
+ * Splits the range [0, count) into contiguous blocks, one per thread of the policy, and calls
+ * body(blockIndex, begin, end) for each of them in parallel. Without an executor, the first block
+ * runs on the calling thread. Returns the number of blocks used, which is never more than count
+ * (but at least one). If any of the calls throws, the exception is rethrown after all blocks have finished.
+ */
+template<class Body>
+size_t parallelBlocks(size_t count, const execution_policy& execution, Body body) {
+	size_t blockCount = execution.limitedTo(count).threadCount;
+	if (blockCount == 1) {
+		body(0, 0, count);
+		return 1;
+	}
+
+	std::vector<std::exception_ptr> exceptions(blockCount);
+
+	auto runBlock = [&](size_t blockIndex) {
+		try {
+			body(blockIndex, count * blockIndex / blockCount, count * (blockIndex + 1) / blockCount);
+		}
+		catch (...) {
+			exceptions[blockIndex] = std::current_exception();
+		}
+	};
+
+	if (blockCount > 1 && execution.executor) {
+		execution.executor(blockCount, runBlock);
+	}
+	else {
+		std::vector<std::thread> threads;
+		for (size_t blockIndex = 1; blockIndex < blockCount; blockIndex++) {
+			threads.emplace_back(runBlock, blockIndex);
+		}
+
+		runBlock(0);
+		for (std::thread& theThread : threads) {
+			theThread.join();
+		}
+	}
+
+	for (const std::exception_ptr& exception : exceptions) {
+		if (exception) {
+			std::rethrow_exception(exception);
+		}
+	}
+
+	return blockCount;
+}
+
+/*
+ * Calls body(threadIndex, itemIndex) for every item in [0, count), on the threads of the policy.
+ * Each thread takes the next item as soon as it's done with the previous one, so items which take
+ * longer than others don't leave the rest of the threads idle. The items should be ordered from the
+ * most expensive to the least, so that the last ones to be taken are short. Exceptions are handled
+ * like in parallelBlocks, and the remaining items are skipped after the first one.
+ */
+template<class Body>
+size_t parallelForEach(size_t count, const execution_policy& execution, Body body) {
+	std::atomic<size_t> nextItem{ 0 };
+	std::atomic<bool> failed{ false };
+
+	return parallelBlocks(execution.limitedTo(count).threadCount, execution, [&](size_t threadIndex, size_t, size_t) {
+		for (size_t itemIndex = nextItem++; itemIndex < count && !failed; itemIndex = nextItem++) {
+			try {
+				body(threadIndex, itemIndex);
+			}
+			catch (...) {
+				failed = true;
+				throw;
+			}
+		}
+	});
+}
+
+/*
+ * Sorts the range like std::sort, with blocks sorted on separate threads and then merged in pairs,
+ * each round of merges again split between the threads.
+ */
+template<class RandomIt, class Compare>
+void parallelSort(RandomIt first, RandomIt last, Compare comp, const execution_policy& execution) {
+	size_t count = last - first;
+	size_t blockCount = parallelBlocks(count, execution, [&](size_t, size_t begin, size_t end) {
+		std::sort(first + begin, first + end, comp);
+	});
+
+	auto blockBegin = [&](size_t blockIndex) {
+		return first + count * std::min(blockIndex, blockCount) / blockCount;
+	};
+
+	for (size_t width = 1; width < blockCount; width *= 2) {
+		parallelBlocks((blockCount + 2 * width - 1) / (2 * width), execution, [&](size_t, size_t begin, size_t end) {
+			for (size_t pairIndex = begin; pairIndex < end; pairIndex++) {
+				size_t lowBlock = 2 * width * pairIndex;
+				std::inplace_merge(blockBegin(lowBlock), blockBegin(lowBlock + width), blockBegin(lowBlock + 2 * width), comp);
+			}
+		});
+	}
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "point.h"
+
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+/*
+ * A point source is any type with size() and operator[](size_t) returning a 3d point-like value,
+ * either by value or by reference. computeConvexHull3D, delaunayTriangulation and
+ * computeVoronoiDiagram read their input through point sources by index, so the input is never
+ * copied as a whole. std::vector is a point source, the types below cover memory which isn't
+ * laid out as a vector of points.
+ */
+template<class Source>
+using point_source_element_t = std::decay_t<decltype(std::declval<const Source&>()[size_t(0)])>;
+
+template<class Source, class = void>
+struct is_point_source : std::false_type {};
+
+template<class Source>
+struct is_point_source<Source, std::void_t<point_source_element_t<Source>, decltype(std::declval<const Source&>().size())>> : std::true_type {};
+
+template<class Source>
+constexpr bool is_point_source_v = is_point_source<Source>::value;
+
+/*
+ * A contiguous array of points owned by someone else.
+ */
+template<class Point>
+struct span_point_source {
+	const Point* data;
+	size_t count;
+
+	size_t size() const {
+		return count;
+	}
+
+	const Point& operator[](size_t index) const {
+		return data[index];
+	}
+};
+
+/*
+ * Points stored as consecutive coordinates in a buffer, with stride elements between the
+ * beginnings of consecutive points, so other data may be interleaved with them. Planar points
+ * have two dimensions and their z is zero.
+ */
+template<class F>
+struct strided_point_source {
+	const F* data;
+	size_t count;
+	size_t stride;
+	size_t dimensions = 3;
+
+	size_t size() const {
+		return count;
+	}
+
+	point<F> operator[](size_t index) const {
+		const F* coordinates = data + index * stride;
+		return { coordinates[0], coordinates[1], dimensions > 2 ? coordinates[2] : F(0) };
+	}
+};
+
+/*
+ * Points stored as separate arrays of coordinates. Planar points have no z array, and their z is zero.
+ */
+template<class F>
+struct soa_point_source {
+	const F* x;
+	const F* y;
+	const F* z;
+	size_t count;
+
+	size_t size() const {
+		return count;
+	}
+
+	point<F> operator[](size_t index) const {
+		return { x[index], y[index], z ? z[index] : F(0) };
+	}
+};
+
+/*
+ * The points of another source at the given indices, in that order.
+ */
+template<class Source>
+struct indexed_point_source {
+	const Source& source;
+	const std::vector<size_t>& indices;
+
+	size_t size() const {
+		return indices.size();
+	}
+
+	decltype(auto) operator[](size_t index) const {
+		return source[indices[index]];
+	}
+};
+
+/*
+ * The count points of another source starting at begin, such as one of the point sets stored
+ * back to back in a single buffer.
+ */
+template<class Source>
+struct range_point_source {
+	const Source& source;
+	size_t begin;
+	size_t count;
+
+	size_t size() const {
+		return count;
+	}
+
+	decltype(auto) operator[](size_t index) const {
+		return source[begin + index];
+	}
+};
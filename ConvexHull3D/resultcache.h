@@ -0,0 +1,518 @@
+#pragma once
+
+#include "indexedhull.h"
+#include "delaunay.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+/*
+ * A cache of hull and Delaunay results, for services which are asked about the same point sets
+ * again and again. Results are keyed by a hash of the coordinates of the points and of the options
+ * which change the result, and kept in the compact form of convex_hull_indices and
+ * delaunay_indices, so a hit costs one pass over the points and no graph is built. The least
+ * recently used results are evicted once their total size exceeds the memory limit. If a directory
+ * is given, every result is also written to a file in it named after its key, from which results
+ * evicted from memory or computed by an earlier process are read back. A file also stores the key
+ * and the number of points, and is only used if both match and all of its indices are in range, so
+ * a stale or corrupt file is a miss rather than a wrong result. The files read or written the
+ * least recently are removed once their total size exceeds the disk limit, if one is given. Keys
+ * have 128 bits, so two point sets getting the same key isn't a practical concern. The cache can
+ * be used from several threads, and results are computed outside of its lock. Results computed
+ * with a cancellation token or a deadline can be partial, so they aren't stored.
+ */
+class hull_result_cache {
+public:
+	struct statistics_type {
+		size_t memoryHits = 0;
+		size_t diskHits = 0;
+		size_t misses = 0;
+	};
+
+private:
+	struct key_type {
+		std::uint64_t low;
+		std::uint64_t high;
+
+		bool operator==(const key_type& other) const {
+			return low == other.low && high == other.high;
+		}
+	};
+
+	struct key_hash {
+		size_t operator()(const key_type& key) const {
+			return size_t(key.low);
+		}
+	};
+
+	enum class result_kind : std::uint8_t {
+		convexHull = 1,
+		delaunay = 2,
+	};
+
+	struct entry {
+		key_type key;
+		std::shared_ptr<const void> result;
+		size_t bytes;
+	};
+
+	size_t m_maxBytes;
+	std::filesystem::path m_directory;
+	std::uintmax_t m_maxDiskBytes;
+
+	mutable std::mutex m_mutex;
+
+	// Guards the size of the files, which is only an estimate between scans of the directory, as
+	// other processes can share it
+	std::mutex m_diskMutex;
+	std::uintmax_t m_diskBytes = 0;
+
+	// The results in memory, the most recently used first
+	std::list<entry> m_entries;
+	std::unordered_map<key_type, std::list<entry>::iterator, key_hash> m_entryIndex;
+	size_t m_bytes = 0;
+	statistics_type m_statistics;
+
+	// The finalizer of splitmix64, which spreads every bit of the value over the whole result
+	static std::uint64_t mix(std::uint64_t value) {
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+		return value ^ (value >> 31);
+	}
+
+	template<class F>
+	static std::uint64_t coordinateBits(F value) {
+		static_assert(std::is_arithmetic_v<F> && sizeof(F) <= sizeof(std::uint64_t), "coordinates should be numbers of at most 64 bits");
+
+		// Both zeros of floating point types are the same coordinate
+		if (value == F(0)) {
+			value = F(0);
+		}
+
+		std::uint64_t bits = 0;
+		std::memcpy(&bits, &value, sizeof(F));
+		return bits;
+	}
+
+	/*
+	 * Hashes the coordinates, Dimensions of them per point, together with the kind of the result
+	 * and the options which change it. Each point is hashed with its index in two independent
+	 * lanes, and the hashes are added up, so the key doesn't depend on how the points are split
+	 * between the threads.
+	 */
+	template<size_t Dimensions, class Source>
+	static key_type computeKey(const Source& points, result_kind kind, const convex_hull_options& options) {
+		using F = decltype(point_source_element_t<Source>::x);
+
+		execution_policy blockExecution = options.execution.forItems(points.size());
+		std::vector<key_type> blockSums(blockExecution.threadCount, key_type{ 0, 0 });
+		size_t blockCount = parallelBlocks(points.size(), blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+			key_type sum = { 0, 0 };
+			for (size_t i = begin; i < end; i++) {
+				const auto& thePoint = points[i];
+				std::uint64_t low = mix(std::uint64_t(i) + 0x9e3779b97f4a7c15ull);
+				std::uint64_t high = mix(std::uint64_t(i) ^ 0xd1b54a32d192ed03ull);
+				low = mix(low ^ coordinateBits(thePoint.x));
+				high = mix(high + coordinateBits(thePoint.x));
+				low = mix(low ^ coordinateBits(thePoint.y));
+				high = mix(high + coordinateBits(thePoint.y));
+				if constexpr (Dimensions == 3) {
+					low = mix(low ^ coordinateBits(thePoint.z));
+					high = mix(high + coordinateBits(thePoint.z));
+				}
+
+				sum.low += low;
+				sum.high += high;
+			}
+			blockSums[blockIndex] = sum;
+		});
+
+		std::uint64_t optionBits = std::uint64_t(kind) | std::uint64_t(options.triangulate) << 8 |
+			std::uint64_t(options.extremeInitialSimplex) << 9 | std::uint64_t(options.removeDuplicates) << 10 |
+			std::uint64_t(sizeof(F)) << 16 | std::uint64_t(std::is_floating_point_v<F>) << 24;
+		key_type key = {
+			mix(mix(optionBits) ^ coordinateBits(options.coplanarityTolerance)) + mix(std::uint64_t(points.size())),
+			mix(mix(optionBits + 1) + coordinateBits(options.coplanarityTolerance)) ^ mix(std::uint64_t(points.size()) + 1)
+		};
+
+		for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+			key.low += blockSums[blockIndex].low;
+			key.high += blockSums[blockIndex].high;
+		}
+
+		return key;
+	}
+
+	// Both kinds of results are an index list and a list of index lists
+	static auto fields(convex_hull_indices& result) {
+		return std::tie(result.vertices, result.faces);
+	}
+
+	static auto fields(const convex_hull_indices& result) {
+		return std::tie(result.vertices, result.faces);
+	}
+
+	static auto fields(delaunay_indices& result) {
+		return std::tie(result.boundary, result.cells);
+	}
+
+	static auto fields(const delaunay_indices& result) {
+		return std::tie(result.boundary, result.cells);
+	}
+
+	template<class Result>
+	static size_t resultBytes(const Result& result) {
+		auto&& [list, lists] = fields(result);
+		size_t bytes = sizeof(Result) + list.size() * sizeof(size_t);
+		for (const auto& innerList : lists) {
+			bytes += sizeof(innerList) + innerList.size() * sizeof(size_t);
+		}
+
+		return bytes;
+	}
+
+	std::filesystem::path resultPath(const key_type& key, result_kind kind) const {
+		char name[40];
+		std::snprintf(name, sizeof(name), "%016llx%016llx", (unsigned long long)key.high, (unsigned long long)key.low);
+		return m_directory / (std::string(name) + (kind == result_kind::convexHull ? ".hull" : ".delaunay"));
+	}
+
+	static bool isResultFile(const std::filesystem::path& path) {
+		return path.extension() == ".hull" || path.extension() == ".delaunay";
+	}
+
+	/*
+	 * Writes the result of the given number of points as a header followed by the indices, with 32
+	 * bits each unless some index needs more. The header holds the kind, the size of the indices,
+	 * the key and the number of points. The file is written under a temporary name and renamed, so
+	 * that readers never see it partially written. Returns the size of the file, or zero if it
+	 * couldn't be written, in which case the result just isn't on disk.
+	 */
+	template<class Result>
+	std::uintmax_t writeResultFile(const key_type& key, result_kind kind, size_t pointCount, const Result& result) const {
+		auto&& [list, lists] = fields(result);
+		size_t maxIndex = std::max(list.size(), lists.size());
+		for (size_t index : list) {
+			maxIndex = std::max(maxIndex, index);
+		}
+		for (const auto& innerList : lists) {
+			maxIndex = std::max(maxIndex, innerList.size());
+			for (size_t index : innerList) {
+				maxIndex = std::max(maxIndex, index);
+			}
+		}
+
+		std::uint8_t indexBytes = maxIndex <= 0xffffffffu ? 4 : 8;
+		std::filesystem::path path = resultPath(key, kind);
+		std::filesystem::path temporaryPath = path;
+		temporaryPath += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "." +
+			std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+		{
+			std::ofstream output(temporaryPath, std::ios::binary);
+			auto writeIndex = [&](size_t index) {
+				std::uint64_t value = index;
+				output.write(reinterpret_cast<const char*>(&value), indexBytes);
+			};
+
+			std::uint8_t header[6] = { 'H', '3', 'R', 'C', std::uint8_t(kind), indexBytes };
+			std::uint64_t headerValues[3] = { key.low, key.high, pointCount };
+			output.write(reinterpret_cast<const char*>(header), sizeof(header));
+			output.write(reinterpret_cast<const char*>(headerValues), sizeof(headerValues));
+			writeIndex(list.size());
+			for (size_t index : list) {
+				writeIndex(index);
+			}
+
+			writeIndex(lists.size());
+			for (const auto& innerList : lists) {
+				writeIndex(innerList.size());
+				for (size_t index : innerList) {
+					writeIndex(index);
+				}
+			}
+
+			output.flush();
+			if (!output) {
+				output.close();
+				std::error_code error;
+				std::filesystem::remove(temporaryPath, error);
+				return 0;
+			}
+		}
+
+		std::error_code error;
+		std::uintmax_t fileSize = std::filesystem::file_size(temporaryPath, error);
+		if (!error) {
+			std::filesystem::rename(temporaryPath, path, error);
+		}
+		if (error) {
+			std::filesystem::remove(temporaryPath, error);
+			return 0;
+		}
+
+		return fileSize;
+	}
+
+	/*
+	 * Reads a result written by writeResultFile. Returns false if there's no such file, or it isn't
+	 * a complete result of the given kind for the given key and number of points, with every index
+	 * less than the number of points.
+	 */
+	template<class Result>
+	bool readResultFile(const key_type& key, result_kind kind, size_t pointCount, Result& result) const {
+		std::ifstream input(resultPath(key, kind), std::ios::binary | std::ios::ate);
+		if (!input) {
+			return false;
+		}
+
+		std::uint64_t fileSize = std::uint64_t(input.tellg());
+		input.seekg(0);
+		std::uint8_t header[6] = {};
+		std::uint64_t headerValues[3] = {};
+		input.read(reinterpret_cast<char*>(header), sizeof(header));
+		input.read(reinterpret_cast<char*>(headerValues), sizeof(headerValues));
+		std::uint8_t indexBytes = header[5];
+		if (!input || std::memcmp(header, "H3RC", 4) || header[4] != std::uint8_t(kind) || (indexBytes != 4 && indexBytes != 8)) {
+			return false;
+		}
+
+		if (headerValues[0] != key.low || headerValues[1] != key.high || headerValues[2] != pointCount) {
+			return false;
+		}
+
+		// A count can't be more than the indices left in the file, which guards the allocations
+		// against corrupt files
+		std::uint64_t maxCount = fileSize / indexBytes;
+		auto readIndex = [&](size_t& index) {
+			std::uint64_t value = 0;
+			input.read(reinterpret_cast<char*>(&value), indexBytes);
+			index = size_t(value);
+			return bool(input);
+		};
+
+		auto&& [list, lists] = fields(result);
+		size_t count = 0;
+		if (!readIndex(count) || count > maxCount) {
+			return false;
+		}
+
+		list.resize(count);
+		for (size_t& index : list) {
+			if (!readIndex(index) || index >= pointCount) {
+				return false;
+			}
+		}
+
+		if (!readIndex(count) || count > maxCount) {
+			return false;
+		}
+
+		lists.resize(count);
+		for (auto& innerList : lists) {
+			if (!readIndex(count) || count > maxCount) {
+				return false;
+			}
+
+			innerList.resize(count);
+			for (size_t& index : innerList) {
+				if (!readIndex(index) || index >= pointCount) {
+					return false;
+				}
+			}
+		}
+
+		return input.peek() == std::ifstream::traits_type::eof();
+	}
+
+	/*
+	 * Sums up the sizes of the result files in the directory, and if they exceed the disk limit,
+	 * removes the least recently used ones until they take at most three quarters of it, so that
+	 * the directory isn't scanned again on every write. Should be called with the disk lock held.
+	 */
+	void trimDirectory() {
+		struct result_file {
+			std::filesystem::file_time_type lastWriteTime;
+			std::uintmax_t bytes;
+			std::filesystem::path path;
+		};
+
+		std::vector<result_file> files;
+		m_diskBytes = 0;
+		std::error_code error;
+		for (std::filesystem::directory_iterator it(m_directory, error), end; !error && it != end; it.increment(error)) {
+			std::error_code fileError;
+			result_file file = { it->last_write_time(fileError), it->file_size(fileError), it->path() };
+			if (!fileError && isResultFile(file.path)) {
+				m_diskBytes += file.bytes;
+				files.push_back(std::move(file));
+			}
+		}
+
+		if (m_diskBytes <= m_maxDiskBytes) {
+			return;
+		}
+
+		std::sort(files.begin(), files.end(), [](const result_file& a, const result_file& b) {
+			return a.lastWriteTime < b.lastWriteTime;
+		});
+
+		std::uintmax_t targetBytes = m_maxDiskBytes / 4 * 3;
+		for (const result_file& file : files) {
+			if (m_diskBytes <= targetBytes) {
+				break;
+			}
+
+			// A file removed by another process no longer counts either
+			std::filesystem::remove(file.path, error);
+			m_diskBytes -= file.bytes;
+		}
+	}
+
+	/*
+	 * Counts a file just written, trimming the directory if the files might exceed the disk limit.
+	 */
+	void addResultFile(std::uintmax_t bytes) {
+		if (m_maxDiskBytes == std::numeric_limits<std::uintmax_t>::max()) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_diskMutex);
+		m_diskBytes += bytes;
+		if (m_diskBytes > m_maxDiskBytes) {
+			trimDirectory();
+		}
+	}
+
+	/*
+	 * Keeps the result in memory, evicting the least recently used ones over the limit. Should be
+	 * called with the lock held.
+	 */
+	void store(const key_type& key, std::shared_ptr<const void> result, size_t bytes) {
+		if (bytes > m_maxBytes || m_entryIndex.count(key)) {
+			return;
+		}
+
+		m_entries.push_front({ key, std::move(result), bytes });
+		m_entryIndex.emplace(key, m_entries.begin());
+		m_bytes += bytes;
+		while (m_bytes > m_maxBytes) {
+			m_bytes -= m_entries.back().bytes;
+			m_entryIndex.erase(m_entries.back().key);
+			m_entries.pop_back();
+		}
+	}
+
+	template<class Result, size_t Dimensions, class Source, class Compute>
+	std::shared_ptr<const Result> find(const Source& points, result_kind kind, const convex_hull_options& options, const Compute& compute) {
+		key_type key = computeKey<Dimensions>(points, kind, options);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto indexIt = m_entryIndex.find(key);
+			if (indexIt != m_entryIndex.end()) {
+				m_entries.splice(m_entries.begin(), m_entries, indexIt->second);
+				m_statistics.memoryHits++;
+				return std::static_pointer_cast<const Result>(indexIt->second->result);
+			}
+		}
+
+		Result loadedResult;
+		if (!m_directory.empty() && readResultFile(key, kind, points.size(), loadedResult)) {
+			// Reading the file counts as using it, for the files to remove first
+			std::error_code error;
+			std::filesystem::last_write_time(resultPath(key, kind), std::filesystem::file_time_type::clock::now(), error);
+
+			size_t bytes = resultBytes(loadedResult);
+			auto result = std::make_shared<const Result>(std::move(loadedResult));
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_statistics.diskHits++;
+			store(key, result, bytes);
+			return result;
+		}
+
+		auto result = std::make_shared<const Result>(compute());
+		bool isComplete = !options.cancellationToken && options.deadline == std::chrono::steady_clock::time_point::max();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_statistics.misses++;
+			if (isComplete) {
+				store(key, result, resultBytes(*result));
+			}
+		}
+
+		if (isComplete && !m_directory.empty()) {
+			addResultFile(writeResultFile(key, kind, points.size(), *result));
+		}
+
+		return result;
+	}
+
+public:
+	/*
+	 * Keeps results of up to maxBytes in total in memory, and of up to maxDiskBytes in the directory
+	 * if it isn't empty, all of them by default. The directory is created if it doesn't exist.
+	 */
+	hull_result_cache(size_t maxBytes, const std::filesystem::path& directory = std::filesystem::path(), std::uintmax_t maxDiskBytes = std::numeric_limits<std::uintmax_t>::max())
+		: m_maxBytes(maxBytes), m_directory(directory), m_maxDiskBytes(maxDiskBytes) {
+		if (!m_directory.empty()) {
+			std::error_code error;
+			std::filesystem::create_directories(m_directory, error);
+			if (m_maxDiskBytes != std::numeric_limits<std::uintmax_t>::max()) {
+				std::lock_guard<std::mutex> lock(m_diskMutex);
+				trimDirectory();
+			}
+		}
+	}
+
+	/*
+	 * Returns the convex hull as indices into the input, see computeConvexHull3DIndices, computing
+	 * it only if it isn't in the cache.
+	 */
+	template<class Source>
+	std::shared_ptr<const convex_hull_indices> computeConvexHull3DIndices(const Source& points, const convex_hull_options& options = convex_hull_options()) {
+		return find<convex_hull_indices, 3>(points, result_kind::convexHull, options, [&]() {
+			return ::computeConvexHull3DIndices(points, options);
+		});
+	}
+
+	/*
+	 * Returns the Delaunay triangulation as indices into the input, see
+	 * delaunayTriangulationIndices, computing it only if it isn't in the cache.
+	 */
+	template<class Source>
+	std::shared_ptr<const delaunay_indices> delaunayTriangulationIndices(const Source& points, const convex_hull_options& options = convex_hull_options()) {
+		return find<delaunay_indices, 2>(points, result_kind::delaunay, options, [&]() {
+			return ::delaunayTriangulationIndices(points, options);
+		});
+	}
+
+	statistics_type statistics() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_statistics;
+	}
+
+	/*
+	 * Returns the estimated size of the results in memory.
+	 */
+	size_t memoryUsage() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_bytes;
+	}
+
+	/*
+	 * Drops the results in memory. The files in the directory are kept.
+	 */
+	void clear() {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_entries.clear();
+		m_entryIndex.clear();
+		m_bytes = 0;
+	}
+};
@@ -0,0 +1,283 @@
+#pragma once
+
+#include "mergehull.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <iostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+/*
+ * The points of a binary point file, of consecutive x, y, z values as read by
+ * binary_point_reader, which one shard worker computes the hull of.
+ */
+struct shard_range {
+	std::string path;
+	size_t firstPoint;
+	size_t pointCount;
+};
+
+/*
+ * Writes the vertices of a shard hull to a stream, as their number followed by the vertices as
+ * binary x, y, z values of type F. This is all a worker sends back, so it's the same whether the
+ * worker is a thread, a local process or a process on another machine.
+ */
+template<class F>
+void writeShardVertices(std::ostream& output, const std::vector<point<F>>& vertices) {
+	std::uint64_t vertexCount = vertices.size();
+	output.write(reinterpret_cast<const char*>(&vertexCount), sizeof(vertexCount));
+	output.write(reinterpret_cast<const char*>(vertices.data()), std::streamsize(vertices.size() * sizeof(point<F>)));
+	output.flush();
+}
+
+/*
+ * Reads the vertices written by writeShardVertices. Throws std::runtime_error if the stream ends
+ * before all of them are read, such as when the worker failed.
+ */
+template<class F>
+std::vector<point<F>> readShardVertices(std::istream& input) {
+	std::uint64_t vertexCount = 0;
+	input.read(reinterpret_cast<char*>(&vertexCount), sizeof(vertexCount));
+	if (size_t(input.gcount()) != sizeof(vertexCount)) {
+		throw std::runtime_error("shard worker sent no hull");
+	}
+
+	// The vertices are read in chunks, so a corrupt count fails at the end of the stream instead
+	// of allocating all of it up front
+	const size_t chunkSize = 1 << 16;
+	std::vector<point<F>> vertices;
+	while (vertices.size() < vertexCount) {
+		size_t previousSize = vertices.size();
+		size_t pointsToRead = std::min<size_t>(chunkSize, size_t(vertexCount) - previousSize);
+		vertices.resize(previousSize + pointsToRead);
+		size_t pointsRead = binary_point_reader<F>{ input }(vertices.data() + previousSize, pointsToRead);
+		if (pointsRead != pointsToRead) {
+			throw std::runtime_error("shard worker sent an incomplete hull");
+		}
+	}
+
+	return vertices;
+}
+
+/*
+ * Computes the hull of the points of a shard, reading them chunkSize at a time, and writes its
+ * vertices with writeShardVertices. The vertices of a flat or collinear shard are written too,
+ * so they aren't lost when merging. Returns false, without writing anything, if the file can't
+ * be read or holds fewer points than the range.
+ */
+template<class F>
+bool writeShardHull(const shard_range& range, std::ostream& output, size_t chunkSize, const convex_hull_options& options = convex_hull_options()) {
+	std::ifstream input(range.path, std::ios::binary | std::ios::ate);
+	std::streamoff fileSize = input.tellg();
+	if (!input || fileSize < std::streamoff((range.firstPoint + range.pointCount) * sizeof(point<F>))) {
+		return false;
+	}
+
+	input.seekg(std::streamoff(range.firstPoint * sizeof(point<F>)));
+
+	incremental_convex_hull<point<F>> hull(options);
+	std::vector<point<F>> chunk;
+	for (size_t pointsLeft = range.pointCount; pointsLeft > 0;) {
+		chunk.resize(std::min(chunkSize, pointsLeft));
+		size_t pointsRead = binary_point_reader<F>{ input }(chunk.data(), chunk.size());
+		if (pointsRead != chunk.size()) {
+			hullgraph::destroyGraph(hull.vertex());
+			return false;
+		}
+
+		pointsLeft -= pointsRead;
+		hull.insert(chunk);
+	}
+
+	writeShardVertices(output, hull.vertices());
+	hullgraph::destroyGraph(hull.vertex());
+	return true;
+}
+
+/*
+ * The entry point of a worker process started by process_shard_launcher. The last three
+ * arguments are the path of the point file, the first point and the number of points of the
+ * shard, and the vertices of its hull are written to the standard output. Returns the exit code
+ * of the process. A program can serve as its own worker by calling this from main when it's
+ * started with the worker arguments.
+ */
+template<class F>
+int runShardWorker(int argc, char** argv, size_t chunkSize = 1 << 20, const convex_hull_options& options = convex_hull_options()) {
+	if (argc < 4) {
+		return 2;
+	}
+
+#ifdef _WIN32
+	_setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+	shard_range range = { argv[argc - 3], size_t(std::stoull(argv[argc - 2])), size_t(std::stoull(argv[argc - 1])) };
+	return writeShardHull<F>(range, std::cout, chunkSize, options) ? 0 : 1;
+}
+
+/*
+ * Starts each shard worker as a local process running the given command followed by the path
+ * of the point file, the first point and the number of points, and reads the hull it writes to
+ * its standard output through a pipe, see runShardWorker. The path is quoted, so it shouldn't
+ * contain quotes itself. A command which starts the worker on another machine, with the file
+ * available there under the same path, works the same way.
+ */
+class process_shard_launcher {
+	/*
+	 * Reads the output of a process. At the end of the output it waits for the process to finish,
+	 * and throws std::runtime_error if it failed, so a worker which crashes after writing its
+	 * hull isn't taken for a successful one. It also waits for the process when destroyed.
+	 */
+	class process_output_stream : public std::istream {
+		class pipe_buffer : public std::streambuf {
+			FILE* m_pipe;
+			char m_buffer[1 << 16];
+
+		protected:
+			int_type underflow() override {
+				if (!m_pipe) {
+					return traits_type::eof();
+				}
+
+				size_t bytesRead = std::fread(m_buffer, 1, sizeof(m_buffer), m_pipe);
+				if (!bytesRead) {
+					if (close()) {
+						throw std::runtime_error("shard worker failed");
+					}
+
+					return traits_type::eof();
+				}
+
+				setg(m_buffer, m_buffer, m_buffer + bytesRead);
+				return traits_type::to_int_type(m_buffer[0]);
+			}
+
+		public:
+			pipe_buffer(FILE* pipe) : m_pipe(pipe) {}
+
+			~pipe_buffer() {
+				if (m_pipe) {
+					close();
+				}
+			}
+
+			/*
+			 * Waits for the process to finish and returns its exit status, zero if it succeeded.
+			 */
+			int close() {
+#ifdef _WIN32
+				int status = _pclose(m_pipe);
+#else
+				int status = pclose(m_pipe);
+#endif
+				m_pipe = nullptr;
+				return status;
+			}
+		};
+
+		pipe_buffer m_buffer;
+
+	public:
+		process_output_stream(FILE* pipe) : std::istream(nullptr), m_buffer(pipe) {
+			rdbuf(&m_buffer);
+
+			// The error of a failed worker reaches the reader instead of only setting badbit
+			exceptions(std::ios::badbit);
+		}
+	};
+
+public:
+	std::string command;
+
+	process_shard_launcher(std::string command) : command(std::move(command)) {}
+
+	/*
+	 * Starts the worker of the shard and returns the stream of its output, which can be read
+	 * while other workers are still running. Throws std::runtime_error if it can't be started.
+	 */
+	std::unique_ptr<std::istream> operator()(const shard_range& range) const {
+		std::string commandLine = command + " \"" + range.path + "\" " + std::to_string(range.firstPoint) + " " + std::to_string(range.pointCount);
+#ifdef _WIN32
+		// The command line goes through cmd /c, which drops the first and the last quote of it
+		// when it has more than two, so it's quoted once more as a whole
+		FILE* pipe = _popen(("\"" + commandLine + "\"").c_str(), "rb");
+#else
+		FILE* pipe = popen(commandLine.c_str(), "r");
+#endif
+		if (!pipe) {
+			throw std::runtime_error("can't start shard worker: " + commandLine);
+		}
+
+		return std::make_unique<process_output_stream>(pipe);
+	}
+};
+
+/*
+ * Computes the convex hull of a binary point file with x, y, z values of type F, split into
+ * shardCount shards of consecutive points. All shards are handed to the launcher first, which
+ * gets a shard_range and returns a std::unique_ptr<std::istream> with the output of its worker,
+ * so the workers run at the same time, see process_shard_launcher. Their outputs are then read
+ * one by one to their end. Only the hull of the shard with the most vertices is built again, and
+ * the vertices of the other shards are merged into it as points with mergeHulls, which locates
+ * them on it instead of building their hulls a second time. The workers should use the same
+ * options. Throws std::runtime_error if the file can't be read or a worker fails.
+ */
+template<class F, class Launcher>
+std::shared_ptr<hullgraph::vertex<point<F>>> computeConvexHull3DSharded(
+	const std::string& path,
+	size_t shardCount,
+	Launcher&& launcher,
+	const convex_hull_options& options = convex_hull_options())
+{
+	std::ifstream input(path, std::ios::binary | std::ios::ate);
+	if (!input) {
+		throw std::runtime_error("can't read point file: " + path);
+	}
+
+	size_t pointCount = size_t(input.tellg()) / sizeof(point<F>);
+	input.close();
+
+	shardCount = std::max<size_t>(1, std::min(shardCount, pointCount));
+	std::vector<std::unique_ptr<std::istream>> outputs;
+	for (size_t i = 0; i < shardCount; i++) {
+		size_t firstPoint = pointCount * i / shardCount;
+		outputs.push_back(launcher(shard_range{ path, firstPoint, pointCount * (i + 1) / shardCount - firstPoint }));
+	}
+
+	std::vector<std::vector<point<F>>> shardVertices;
+	for (auto& output : outputs) {
+		shardVertices.push_back(readShardVertices<F>(*output));
+		if (output->peek() != std::istream::traits_type::eof()) {
+			throw std::runtime_error("shard worker sent more than a hull");
+		}
+
+		output.reset();
+	}
+
+	// The vertices of flat and collinear shards, which have no graph, are merged as points too
+	size_t largestShard = 0;
+	for (size_t i = 1; i < shardCount; i++) {
+		if (shardVertices[i].size() > shardVertices[largestShard].size()) {
+			largestShard = i;
+		}
+	}
+
+	std::vector<point<F>> otherVertices;
+	for (size_t i = 0; i < shardCount; i++) {
+		if (i != largestShard) {
+			otherVertices.insert(otherVertices.end(), shardVertices[i].begin(), shardVertices[i].end());
+		}
+	}
+
+	return mergeHulls(computeConvexHull3D(shardVertices[largestShard], options), otherVertices, options);
+}
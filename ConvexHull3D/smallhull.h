@@ -0,0 +1,344 @@
+#pragma once
+
+#include "indexedhull.h"
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <limits>
+
+/*
+ * The convex hull of at most MaxPoints points, built by computeSmallConvexHull3D without touching
+ * the heap. Faces are triangles in a fixed array, each with the indices of its neighbors and a
+ * bitset of the points which are outside of it.
+ */
+template<class Source, size_t MaxPoints>
+class small_convex_hull {
+	using Point = point_source_element_t<Source>;
+	using F = decltype(Point::x);
+	using index_type = std::uint16_t;
+
+	static constexpr size_t maxFaces = 3 * MaxPoints;
+	static constexpr index_type none = std::numeric_limits<index_type>::max();
+	static_assert(maxFaces < none, "MaxPoints is too large for 16-bit face indices");
+
+	// The face across the edge from vertices[i] to vertices[(i + 1) % 3] is neighbors[i]. Points
+	// inside the hull have a negative orientation with respect to the vertices, in this order.
+	struct small_face {
+		std::array<index_type, 3> vertices;
+		std::array<index_type, 3> neighbors;
+		bool alive;
+		std::bitset<MaxPoints> conflicts;
+	};
+
+	const Source& m_points;
+
+	// A hull of n points has at most 2n - 4 faces, and a step adds at most n more before it
+	// removes the visible ones
+	std::array<small_face, maxFaces> m_faces;
+	std::array<index_type, maxFaces> m_freeFaces;
+	size_t m_faceCount = 0;
+	size_t m_freeCount = 0;
+
+	// The points which haven't been added yet
+	std::bitset<MaxPoints> m_pending;
+
+	F faceOrientation(const small_face& theFace, size_t pointIndex) const {
+		return orientation(m_points[theFace.vertices[0]], m_points[theFace.vertices[1]], m_points[theFace.vertices[2]], m_points[pointIndex]);
+	}
+
+	index_type addFace(size_t a, size_t b, size_t c) {
+		index_type faceIndex = m_freeCount ? m_freeFaces[--m_freeCount] : index_type(m_faceCount++);
+		small_face& theFace = m_faces[faceIndex];
+		theFace.vertices = { index_type(a), index_type(b), index_type(c) };
+		theFace.neighbors = { none, none, none };
+		theFace.alive = true;
+		theFace.conflicts.reset();
+		return faceIndex;
+	}
+
+	/*
+	 * Finds the pending points among the candidates which are outside of the face.
+	 */
+	void findConflicts(small_face& theFace, const std::bitset<MaxPoints>& candidates) {
+		for (size_t k = 0; k < m_points.size(); k++) {
+			if (candidates[k] && faceOrientation(theFace, k) > F(0)) {
+				theFace.conflicts[k] = true;
+			}
+		}
+	}
+
+	/*
+	 * Builds the tetrahedron from the first four points which span the space, or returns false if
+	 * there are no such points. The indices of the points found so far are left in simplex.
+	 */
+	bool buildTetrahedron(std::array<size_t, 4>& simplex, size_t& simplexSize) {
+		size_t n = m_points.size();
+		simplexSize = 0;
+		for (size_t i = 0; i < n && simplexSize < 4; i++) {
+			const Point& thePoint = m_points[i];
+			bool extends =
+				simplexSize == 0 ||
+				(simplexSize == 1 && thePoint != m_points[simplex[0]]) ||
+				(simplexSize == 2 && !collinear(m_points[simplex[0]], m_points[simplex[1]], thePoint)) ||
+				(simplexSize == 3 && orientation(m_points[simplex[0]], m_points[simplex[1]], m_points[simplex[2]], thePoint) != F(0));
+
+			if (extends) {
+				simplex[simplexSize++] = i;
+			}
+		}
+
+		if (simplexSize < 4) {
+			return false;
+		}
+
+		// Each face leaves out one vertex, which has to be on its inner side
+		index_type tetrahedron[4];
+		for (size_t omitted = 0; omitted < 4; omitted++) {
+			size_t a = simplex[(omitted + 1) % 4], b = simplex[(omitted + 2) % 4], c = simplex[(omitted + 3) % 4];
+			if (orientation(m_points[a], m_points[b], m_points[c], m_points[simplex[omitted]]) > F(0)) {
+				std::swap(b, c);
+			}
+
+			tetrahedron[omitted] = addFace(a, b, c);
+		}
+
+		for (index_type faceIndex : tetrahedron) {
+			for (size_t i = 0; i < 3; i++) {
+				index_type u = m_faces[faceIndex].vertices[i], w = m_faces[faceIndex].vertices[(i + 1) % 3];
+				for (index_type otherIndex : tetrahedron) {
+					for (size_t j = 0; j < 3; j++) {
+						if (m_faces[otherIndex].vertices[j] == w && m_faces[otherIndex].vertices[(j + 1) % 3] == u) {
+							m_faces[faceIndex].neighbors[i] = otherIndex;
+						}
+					}
+				}
+			}
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			m_pending[i] = true;
+		}
+		for (size_t i = 0; i < 4; i++) {
+			m_pending[simplex[i]] = false;
+		}
+		for (index_type faceIndex : tetrahedron) {
+			findConflicts(m_faces[faceIndex], m_pending);
+		}
+
+		return true;
+	}
+
+	/*
+	 * Adds the point, replacing the faces it's outside of with a cone from the point to their boundary.
+	 */
+	void addPoint(size_t pointIndex) {
+		m_pending[pointIndex] = false;
+
+		std::array<index_type, maxFaces> visible;
+		size_t visibleCount = 0;
+		for (size_t faceIndex = 0; faceIndex < m_faceCount; faceIndex++) {
+			if (m_faces[faceIndex].alive && m_faces[faceIndex].conflicts[pointIndex]) {
+				visible[visibleCount++] = index_type(faceIndex);
+			}
+		}
+
+		if (!visibleCount) {
+			return;
+		}
+
+		// A new face on each edge of the horizon, which is the boundary of the visible faces.
+		// The new faces are linked to each other through the vertices where they start.
+		std::array<index_type, MaxPoints> startingAt;
+		std::array<index_type, MaxPoints> newFaces;
+		size_t newFaceCount = 0;
+		for (size_t k = 0; k < visibleCount; k++) {
+			index_type visibleIndex = visible[k];
+			for (size_t i = 0; i < 3; i++) {
+				index_type outerIndex = m_faces[visibleIndex].neighbors[i];
+				if (m_faces[outerIndex].conflicts[pointIndex]) {
+					continue;
+				}
+
+				index_type a = m_faces[visibleIndex].vertices[i], b = m_faces[visibleIndex].vertices[(i + 1) % 3];
+				index_type newIndex = addFace(a, b, pointIndex);
+				small_face& newFace = m_faces[newIndex];
+				newFace.neighbors[0] = outerIndex;
+				for (index_type& outerNeighbor : m_faces[outerIndex].neighbors) {
+					if (outerNeighbor == visibleIndex) {
+						outerNeighbor = newIndex;
+					}
+				}
+
+				// Only points outside of one of the two faces around the edge can be outside of the new one
+				findConflicts(newFace, (m_faces[visibleIndex].conflicts | m_faces[outerIndex].conflicts) & m_pending);
+				startingAt[a] = newIndex;
+				newFaces[newFaceCount++] = newIndex;
+			}
+		}
+
+		for (size_t k = 0; k < newFaceCount; k++) {
+			small_face& newFace = m_faces[newFaces[k]];
+			index_type nextIndex = startingAt[newFace.vertices[1]];
+			newFace.neighbors[1] = nextIndex;
+			m_faces[nextIndex].neighbors[2] = newFaces[k];
+		}
+
+		for (size_t k = 0; k < visibleCount; k++) {
+			m_faces[visible[k]].alive = false;
+			m_freeFaces[m_freeCount++] = visible[k];
+		}
+	}
+
+	/*
+	 * Merges coplanar triangles into polygons and lists them with their vertices, leaving out
+	 * vertices in the middle of a polygon side, the same way computeConvexHull3D does.
+	 */
+	void collectFaces(convex_hull_indices& result) const {
+		// Group the faces with union-find over coplanar neighbors
+		std::array<index_type, maxFaces> group;
+		auto findGroup = [&](index_type faceIndex) {
+			while (group[faceIndex] != faceIndex) {
+				faceIndex = group[faceIndex] = group[group[faceIndex]];
+			}
+			return faceIndex;
+		};
+
+		for (size_t faceIndex = 0; faceIndex < m_faceCount; faceIndex++) {
+			group[faceIndex] = index_type(faceIndex);
+		}
+
+		for (size_t faceIndex = 0; faceIndex < m_faceCount; faceIndex++) {
+			const small_face& theFace = m_faces[faceIndex];
+			if (!theFace.alive) {
+				continue;
+			}
+
+			for (index_type neighborIndex : theFace.neighbors) {
+				bool isCoplanar = true;
+				for (index_type neighborVertex : m_faces[neighborIndex].vertices) {
+					isCoplanar &= faceOrientation(theFace, neighborVertex) == F(0);
+				}
+
+				if (isCoplanar) {
+					group[findGroup(index_type(faceIndex))] = findGroup(neighborIndex);
+				}
+			}
+		}
+
+		// The faces of each group, as linked lists
+		std::array<index_type, maxFaces> groupHead, nextInGroup;
+		groupHead.fill(none);
+		for (size_t faceIndex = 0; faceIndex < m_faceCount; faceIndex++) {
+			if (m_faces[faceIndex].alive) {
+				index_type root = findGroup(index_type(faceIndex));
+				nextInGroup[faceIndex] = groupHead[root];
+				groupHead[root] = index_type(faceIndex);
+			}
+		}
+
+		std::bitset<MaxPoints> isHullVertex;
+		std::array<index_type, MaxPoints> nextVertex, polygon;
+		for (size_t root = 0; root < m_faceCount; root++) {
+			if (groupHead[root] == none) {
+				continue;
+			}
+
+			// The boundary of a group is a convex polygon, so each of its vertices starts one edge
+			index_type start = none;
+			for (index_type faceIndex = groupHead[root]; faceIndex != none; faceIndex = nextInGroup[faceIndex]) {
+				const small_face& theFace = m_faces[faceIndex];
+				for (size_t i = 0; i < 3; i++) {
+					if (findGroup(theFace.neighbors[i]) != root) {
+						nextVertex[theFace.vertices[i]] = theFace.vertices[(i + 1) % 3];
+						start = theFace.vertices[i];
+					}
+				}
+			}
+
+			size_t polygonSize = 0;
+			index_type walkingVertex = start;
+			do {
+				polygon[polygonSize++] = walkingVertex;
+				walkingVertex = nextVertex[walkingVertex];
+			} while (walkingVertex != start);
+
+			std::vector<size_t> faceIndices;
+			for (size_t i = 0; i < polygonSize; i++) {
+				index_type previous = polygon[(i + polygonSize - 1) % polygonSize], next = polygon[(i + 1) % polygonSize];
+				if (!collinear(m_points[previous], m_points[polygon[i]], m_points[next])) {
+					faceIndices.push_back(polygon[i]);
+					isHullVertex[polygon[i]] = true;
+				}
+			}
+
+			result.faces.push_back(faceIndices);
+		}
+
+		for (size_t i = 0; i < m_points.size(); i++) {
+			if (isHullVertex[i]) {
+				result.vertices.push_back(i);
+			}
+		}
+	}
+
+public:
+	small_convex_hull(const Source& points) : m_points(points) {}
+
+	/*
+	 * Computes the hull, see computeSmallConvexHull3D.
+	 */
+	convex_hull_indices compute() {
+		convex_hull_indices result;
+		std::array<size_t, 4> simplex;
+		size_t simplexSize;
+
+		if (!buildTetrahedron(simplex, simplexSize)) {
+			if (simplexSize == 3) {
+				// Both sides of the polygon, the same as computeConvexHull3DIndices
+				point<F> normalVector = vectorProduct(m_points[simplex[1]] - m_points[simplex[0]], m_points[simplex[2]] - m_points[simplex[0]]);
+				std::vector<size_t> faceIndices;
+				for (const auto& hullPoint : planarConvexHull(index_labeled_point_source<Source>{ m_points }, normalVector)) {
+					faceIndices.push_back(hullPoint.label);
+				}
+
+				result.vertices = faceIndices;
+				std::sort(result.vertices.begin(), result.vertices.end());
+				result.faces.push_back(faceIndices);
+				std::reverse(faceIndices.begin(), faceIndices.end());
+				result.faces.push_back(faceIndices);
+			}
+
+			return result;
+		}
+
+		for (size_t i = 0; i < m_points.size(); i++) {
+			if (m_pending[i]) {
+				addPoint(i);
+			}
+		}
+
+		collectFaces(result);
+		return result;
+	}
+};
+
+/*
+ * Computes the convex hull of at most MaxPoints points, returning the same faces and vertices as
+ * computeConvexHull3DIndices (up to the order of the faces and which vertex a face starts from).
+ * All the work is done on the stack, in arrays sized by MaxPoints: faces are triangles with
+ * neighbor indices, and the points outside of each face are a bitset, so only the result is
+ * allocated. Points are added in input order, which is fine for so few of them. Inputs with more
+ * than MaxPoints points are passed on to computeConvexHull3DIndices.
+ * The faces take about 3 * MaxPoints * (MaxPoints / 8 + 16) bytes of stack, which is 5 KB for 64
+ * points and 40 KB for 256.
+ */
+template<size_t MaxPoints = 64, class Source>
+convex_hull_indices computeSmallConvexHull3D(const Source& points) {
+	if (points.size() > MaxPoints) {
+		return computeConvexHull3DIndices(points);
+	}
+
+	small_convex_hull<Source, MaxPoints> hull(points);
+	return hull.compute();
+}
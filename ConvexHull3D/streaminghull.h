@@ -0,0 +1,91 @@
+#pragma once
+
+#include "hull3d.h"
+
+#include <istream>
+#include <stdexcept>
+
+/*
+ * A point source reading consecutive binary x, y, z values of type F from a stream. Throws
+ * std::runtime_error if the stream ends in the middle of a point.
+ */
+template<class F>
+struct binary_point_reader {
+	std::istream& stream;
+
+	size_t operator()(point<F>* buffer, size_t maxCount) {
+		stream.read(reinterpret_cast<char*>(buffer), std::streamsize(maxCount * sizeof(point<F>)));
+		size_t bytesRead = size_t(stream.gcount());
+		if (bytesRead % sizeof(point<F>)) {
+			throw std::runtime_error("point stream ends in the middle of a point");
+		}
+
+		return bytesRead / sizeof(point<F>);
+	}
+};
+
+/*
+ * Computes the convex hull of a stream of points which doesn't have to fit in memory.
+ * The source is called as source(buffer, maxCount) with a Point* buffer, it should write up to
+ * maxCount points into it and return how many it wrote, or zero at the end of the stream.
+ * Points are read chunkSize at a time and each chunk is inserted into the hull built from the
+ * previous ones, so only the hull and a single chunk (with its conflict graph) are kept in memory.
+ * The result is the same hull computeConvexHull3D would give for all points of the stream with
+ * the same options, except that with a coplanarityTolerance the merged faces may differ slightly,
+ * see convex_hull_options. The options apply to each chunk, so chunks are inserted in parallel as set by
+ * their execution policy. If the cancellation token or the deadline stops an insertion, no more
+ * chunks are read and the hull of the points added so far is returned.
+ * Throws std::invalid_argument if chunkSize is zero.
+ */
+template<class Point, class Source, class Callback>
+std::shared_ptr<hullgraph::vertex<Point>> computeConvexHull3DStreaming(Source source, size_t chunkSize, const convex_hull_options& options, Callback callback) {
+	if (!chunkSize) {
+		throw std::invalid_argument("chunkSize must be positive");
+	}
+
+	incremental_convex_hull<Point> hull(options);
+	std::vector<Point> chunk;
+
+	try {
+		while (!hull.isPartial()) {
+			chunk.resize(chunkSize);
+			size_t pointsRead = source(chunk.data(), chunkSize);
+			if (!pointsRead) {
+				break;
+			}
+
+			chunk.resize(pointsRead);
+			hull.insert(std::move(chunk), callback);
+			chunk.clear();
+		}
+	}
+	catch (...) {
+		hullgraph::destroyGraph(hull.vertex());
+		throw;
+	}
+
+	return hull.vertex();
+}
+
+template<class Point, class Source>
+std::shared_ptr<hullgraph::vertex<Point>> computeConvexHull3DStreaming(Source source, size_t chunkSize, const convex_hull_options& options) {
+	return computeConvexHull3DStreaming<Point>(source, chunkSize, options, [](convex_hull_update, const std::shared_ptr<hullgraph::vertex<Point>>&) {});
+}
+
+template<class Point, class Source, class Callback>
+std::shared_ptr<hullgraph::vertex<Point>> computeConvexHull3DStreaming(Source source, size_t chunkSize, Callback callback) {
+	return computeConvexHull3DStreaming<Point>(source, chunkSize, convex_hull_options(), callback);
+}
+
+template<class Point, class Source>
+std::shared_ptr<hullgraph::vertex<Point>> computeConvexHull3DStreaming(Source source, size_t chunkSize) {
+	return computeConvexHull3DStreaming<Point>(source, chunkSize, convex_hull_options());
+}
+
+/*
+ * Computes the convex hull of the binary x, y, z values of type F stored in the given stream.
+ */
+template<class F>
+std::shared_ptr<hullgraph::vertex<point<F>>> computeConvexHull3DFromStream(std::istream& stream, size_t chunkSize, const convex_hull_options& options = convex_hull_options()) {
+	return computeConvexHull3DStreaming<point<F>>(binary_point_reader<F>{ stream }, chunkSize, options);
+}
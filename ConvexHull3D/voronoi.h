@@ -28,7 +28,7 @@ typename voronoi_diagram<decltype(Point::x)>::point circumcenter(
 	const std::shared_ptr<hullgraph::face<Point>>& outerFace)
 {
 	using F = decltype(Point::x);
-	using vd_point = voronoi_diagram<F>::point;
+	using vd_point = typename voronoi_diagram<F>::point;
 
 	if (halfEdge->incidentFace() == outerFace) {
 		vd_point result;
@@ -69,15 +69,17 @@ typename voronoi_diagram<decltype(Point::x)>::point circumcenter(
 }
 
 /*
- * Given the outer face of the Delaunay triangulation, computes the Voronoi diagram.
+ * Given the outer face of the Delaunay triangulation, computes the Voronoi diagram. The
+ * circumcenters and the edges are computed in parallel as set by the execution policy.
  */
 template<class Point>
-voronoi_diagram<decltype(Point::x)> computeVoronoiDiagram(const std::shared_ptr<hullgraph::face<Point>>& outerFace) {
+voronoi_diagram<decltype(Point::x)> computeVoronoiDiagram(
+	const std::shared_ptr<hullgraph::face<Point>>& outerFace,
+	const execution_policy& execution = execution_policy())
+{
 	using F = decltype(Point::x);
 	using faceptr = std::shared_ptr<hullgraph::face<Point>>;
 	using edgeptr = std::shared_ptr<hullgraph::edge<Point>>;
-	using vertexptr = std::shared_ptr<hullgraph::vertex<Point>>;
-	using vd_point = voronoi_diagram<F>::point;
 
 	voronoi_diagram<F> result;
 
@@ -88,56 +90,88 @@ voronoi_diagram<decltype(Point::x)> computeVoronoiDiagram(const std::shared_ptr<
 
 	auto allEdges = exploreGraph(outerFace->outerComponent()->origin());
 
+	// The edge each point is computed from
+	std::vector<edgeptr> pointEdges;
 	for (const auto& theEdge : allEdges) {
 		auto theFace = theEdge->incidentFace();
 		if (theFace != outerFace) {
-			auto it = internalFaceToPointIdx.find(theFace);
-			if (it == internalFaceToPointIdx.end()) {
-				vd_point newPoint = circumcenter(theEdge, outerFace);
-				internalFaceToPointIdx[theFace] = result.pointList.size();
-				result.pointList.push_back(newPoint);
+			if (internalFaceToPointIdx.emplace(theFace, pointEdges.size()).second) {
+				pointEdges.push_back(theEdge);
 			}
 		}
 		else {
-			vd_point newPoint = circumcenter(theEdge, outerFace);
-			outerFaceEdgeToPointIdx[theEdge] = result.pointList.size();
-			result.pointList.push_back(newPoint);
+			outerFaceEdgeToPointIdx[theEdge] = pointEdges.size();
+			pointEdges.push_back(theEdge);
 		}
 	}
 
-	for (const auto& theEdge : allEdges) {
-		auto twinEdge = theEdge->twin();
-
-		// Ensure that we process edge/twin edge pair exactly once
-		if (theEdge < twinEdge) {
-			if (theEdge->incidentFace() == outerFace) {
-				result.edgeList.push_back({
-					outerFaceEdgeToPointIdx[theEdge],
-					internalFaceToPointIdx[twinEdge->incidentFace()]
-					});
-			}
-			else if (twinEdge->incidentFace() == outerFace) {
-				result.edgeList.push_back({
-					outerFaceEdgeToPointIdx[twinEdge],
-					internalFaceToPointIdx[theEdge->incidentFace()]
-					});
-			}
-			else {
-				result.edgeList.push_back({
-					internalFaceToPointIdx[theEdge->incidentFace()],
-					internalFaceToPointIdx[twinEdge->incidentFace()]
-					});
+	result.pointList.resize(pointEdges.size());
+	parallelBlocks(pointEdges.size(), execution.forItems(pointEdges.size(), 1 << 12), [&](size_t, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			result.pointList[i] = circumcenter(pointEdges[i], outerFace);
+		}
+	});
+
+	// The maps are only read from here on, so the edges are split into blocks exported in parallel
+	// and joined in the order of the blocks
+	execution_policy blockExecution = execution.forItems(allEdges.size(), 1 << 12);
+	std::vector<std::vector<typename voronoi_diagram<F>::edge>> blockEdgeLists(blockExecution.threadCount);
+	size_t blockCount = parallelBlocks(allEdges.size(), blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+		std::vector<typename voronoi_diagram<F>::edge>& edgeList = blockEdgeLists[blockIndex];
+		for (size_t i = begin; i < end; i++) {
+			const auto& theEdge = allEdges[i];
+			auto twinEdge = theEdge->twin();
+
+			// Ensure that we process edge/twin edge pair exactly once
+			if (theEdge < twinEdge) {
+				if (theEdge->incidentFace() == outerFace) {
+					edgeList.push_back({
+						outerFaceEdgeToPointIdx.at(theEdge),
+						internalFaceToPointIdx.at(twinEdge->incidentFace())
+						});
+				}
+				else if (twinEdge->incidentFace() == outerFace) {
+					edgeList.push_back({
+						outerFaceEdgeToPointIdx.at(twinEdge),
+						internalFaceToPointIdx.at(theEdge->incidentFace())
+						});
+				}
+				else {
+					edgeList.push_back({
+						internalFaceToPointIdx.at(theEdge->incidentFace()),
+						internalFaceToPointIdx.at(twinEdge->incidentFace())
+						});
+				}
 			}
 		}
+	});
+
+	for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+		result.edgeList.insert(result.edgeList.end(), blockEdgeLists[blockIndex].begin(), blockEdgeLists[blockIndex].end());
 	}
 
 	return result;
 }
 
 /*
- * Given a list of points, compute the Voronoi diagram.
+ * Given a list of points, compute the Voronoi diagram. The points can come from any point source,
+ * and the options are passed on to delaunayTriangulation.
  */
-template<class Point>
-voronoi_diagram<decltype(Point::x)> computeVoronoiDiagram(const std::vector<Point>& points) {
-	return computeVoronoiDiagram(delaunayTriangulation(points));
+template<class Source, class = std::enable_if_t<is_point_source_v<Source>>>
+voronoi_diagram<decltype(point_source_element_t<Source>::x)> computeVoronoiDiagram(const Source& points, const convex_hull_options& options = convex_hull_options()) {
+	return computeVoronoiDiagram(delaunayTriangulation(points, options), options.execution);
+}
+
+/*
+ * Computes the Voronoi diagram with the given execution policy instead of the one in the options.
+ */
+template<class Source, class = std::enable_if_t<is_point_source_v<Source>>>
+voronoi_diagram<decltype(point_source_element_t<Source>::x)> computeVoronoiDiagram(
+	const execution_policy& execution,
+	const Source& points,
+	const convex_hull_options& options = convex_hull_options())
+{
+	convex_hull_options policyOptions = options;
+	policyOptions.execution = execution;
+	return computeVoronoiDiagram(points, policyOptions);
 }
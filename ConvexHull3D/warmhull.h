@@ -0,0 +1,142 @@
+#pragma once
+
+#include "hull3d.h"
+
+#include <limits>
+
+/*
+ * The plane of a hull face, for testing many points against the hull without walking the graph.
+ * A point is outside of the face if scalarProduct(normal, thePoint - origin) is positive.
+ */
+template<class F>
+struct face_plane {
+	point<F> origin;
+	point<F> normal;
+	double inverseNormLength;
+};
+
+/*
+ * Computes the convex hull of the points, starting from the vertices of a previous hull which are
+ * still among them, such as the hull of the previous frame of a slowly changing scene. The hull of
+ * those vertices is built first, then all points are tested against its faces in a single parallel
+ * pass over flat plane equations, and only the points outside of it are added with the usual
+ * incremental steps. When most of the previous vertices are still there, almost all points are
+ * dropped by the pass, which costs a few multiplications per face instead of the conflict graph
+ * updates of computeConvexHull3D. Previous vertices are matched by their coordinates. If the ones
+ * still there don't span the space, or previousHull is null, the hull is computed from scratch.
+ * Unless the options triangulate the faces or have a coplanarity tolerance, which make the result
+ * depend on the order of insertion, the result is the same hull computeConvexHull3D would give.
+ */
+template<class Source>
+std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>> computeConvexHull3DWarm(
+	const std::shared_ptr<hullgraph::vertex<point_source_element_t<Source>>>& previousHull,
+	const Source& points,
+	const convex_hull_options& options = convex_hull_options())
+{
+	using namespace hullgraph;
+	using Point = point_source_element_t<Source>;
+	using F = decltype(Point::x);
+
+	execution_policy blockExecution = options.execution.forItems(points.size());
+
+	std::vector<point<F>> previousVertices;
+	if (previousHull) {
+		for (const auto& theEdge : exploreGraph(previousHull)) {
+			const Point& thePoint = theEdge->origin()->data();
+			previousVertices.push_back({ thePoint.x, thePoint.y, thePoint.z });
+		}
+	}
+
+	std::sort(previousVertices.begin(), previousVertices.end());
+	previousVertices.erase(std::unique(previousVertices.begin(), previousVertices.end()), previousVertices.end());
+
+	// The first index of each previous vertex among the points, found by each block separately
+	const size_t none = std::numeric_limits<size_t>::max();
+	std::vector<std::vector<size_t>> blockMatches(blockExecution.threadCount);
+	size_t blockCount = parallelBlocks(previousVertices.empty() ? 0 : points.size(), blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+		std::vector<size_t>& matches = blockMatches[blockIndex];
+		matches.assign(previousVertices.size(), none);
+		for (size_t i = begin; i < end; i++) {
+			const Point& thePoint = points[i];
+			auto it = std::lower_bound(previousVertices.begin(), previousVertices.end(), point<F>{ thePoint.x, thePoint.y, thePoint.z });
+			if (it != previousVertices.end() && *it == point<F>{ thePoint.x, thePoint.y, thePoint.z }) {
+				size_t& match = matches[it - previousVertices.begin()];
+				match = std::min(match, i);
+			}
+		}
+	});
+
+	std::vector<size_t> seedIndices;
+	for (size_t k = 0; k < previousVertices.size(); k++) {
+		size_t match = none;
+		for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+			match = std::min(match, blockMatches[blockIndex][k]);
+		}
+
+		if (match != none) {
+			seedIndices.push_back(match);
+		}
+	}
+
+	std::sort(seedIndices.begin(), seedIndices.end());
+
+	incremental_convex_hull<Point> hull(options);
+	hull.insert(indexed_point_source<Source>{ points, seedIndices });
+	if (!hull.isFullDimensional()) {
+		hull.insert(points);
+		return hull.vertex();
+	}
+
+	std::vector<face_plane<F>> planes;
+	{
+		std::unordered_set<std::shared_ptr<face<Point>>> visitedFaces;
+		for (const auto& theEdge : exploreGraph(hull.vertex())) {
+			if (visitedFaces.insert(theEdge->incidentFace()).second) {
+				const Point& a = theEdge->origin()->data();
+				const Point& b = theEdge->destination()->data();
+				const Point& c = theEdge->next()->destination()->data();
+				point<F> normal = vectorProduct(b - a, c - a);
+				planes.push_back({ { a.x, a.y, a.z }, normal, 1 / std::sqrt(double(scalarProduct(normal, normal))) });
+			}
+		}
+	}
+
+	// Most points are inside of every face, the ones which aren't tend to be outside of the same
+	// face as the point before them, so that face is tried first
+	std::vector<std::vector<size_t>> blockOutside(blockExecution.threadCount);
+	blockCount = parallelBlocks(points.size(), blockExecution, [&](size_t blockIndex, size_t begin, size_t end) {
+		size_t lastOutsideFace = 0;
+		auto isOutside = [&](const face_plane<F>& plane, const Point& thePoint) {
+			F value = scalarProduct(plane.normal, point<F>{ thePoint.x, thePoint.y, thePoint.z } - plane.origin);
+			if (options.coplanarityTolerance > 0) {
+				return double(value) * plane.inverseNormLength > options.coplanarityTolerance;
+			}
+
+			return value > F(0);
+		};
+
+		for (size_t i = begin; i < end; i++) {
+			const Point& thePoint = points[i];
+			if (isOutside(planes[lastOutsideFace], thePoint)) {
+				blockOutside[blockIndex].push_back(i);
+				continue;
+			}
+
+			for (size_t k = 0; k < planes.size(); k++) {
+				if (isOutside(planes[k], thePoint)) {
+					blockOutside[blockIndex].push_back(i);
+					lastOutsideFace = k;
+					break;
+				}
+			}
+		}
+	});
+
+	std::vector<size_t> outsideIndices;
+	for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+		outsideIndices.insert(outsideIndices.end(), blockOutside[blockIndex].begin(), blockOutside[blockIndex].end());
+	}
+
+	hull.insert(indexed_point_source<Source>{ points, outsideIndices });
+	return hull.vertex();
+}
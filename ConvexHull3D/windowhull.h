@@ -0,0 +1,159 @@
+#pragma once
+
+#include "indexedhull.h"
+
+#include <map>
+
+/*
+ * The convex hull of the last points of a stream, as a queue which points are pushed onto at the
+ * back and popped from at the front. Each point is labeled with its sequence number, the number of
+ * points pushed before it, and the hull is exported in terms of those.
+ *
+ * The queue is made of two stacks. Pushed points go to the back stack, whose hull is kept by an
+ * incremental_convex_hull and brought up to date in batches when the hull of the window is needed.
+ * Popping from an empty front stack moves the whole back stack over, inserting its points from the
+ * newest to the oldest into a new hull and recording how its vertices change with each of them.
+ * The vertices of the hull of the front stack are kept, and popping a point undoes its change, so
+ * they become the vertices of the hull of the points after it. A point adds at most itself to the
+ * vertices and each point is removed from them at most once, so the records of a window of W
+ * points take O(W) space in total, even when every point is a vertex, as for points along a convex
+ * curve. Every point is inserted into two hulls over its lifetime, so with h vertices in a hull,
+ * pushing and popping take O(h) amortized time, and the hull of the whole window is computed on
+ * demand from the two hulls of at most 2h vertices in total.
+ */
+template<class Point>
+class sliding_window_hull {
+	using F = decltype(Point::x);
+	using window_point = labeled_point<F, size_t>;
+
+	// The vertices a point of the front stack adds to the hull of the points after it, and the
+	// ones it removes
+	struct vertex_change {
+		std::vector<window_point> added;
+		std::vector<window_point> removed;
+	};
+
+	convex_hull_options m_options;
+	size_t m_nextSequenceNumber = 0;
+
+	std::vector<window_point> m_back;
+
+	// The hull of the first m_backHullSize points of the back stack
+	mutable incremental_convex_hull<window_point> m_backHull;
+	mutable size_t m_backHullSize = 0;
+
+	// The change of each point of the front stack, the oldest last, and the vertices of the hull
+	// of the whole front stack by their sequence number
+	std::vector<vertex_change> m_front;
+	std::map<size_t, window_point> m_frontVertices;
+
+	/*
+	 * Moves the back stack to the front, see the class comment.
+	 */
+	void moveBackToFront() {
+		auto byLabel = [](const window_point& a, const window_point& b) {
+			return a.label < b.label;
+		};
+
+		incremental_convex_hull<window_point> suffixHull(m_options);
+		std::vector<window_point> previousVertices;
+		for (size_t i = m_back.size(); i-- > 0;) {
+			// A point dropped by a full-dimensional hull leaves it as it was, without any update
+			bool isUpdated = false;
+			suffixHull.insert(m_back[i], [&](convex_hull_update, const auto&) {
+				isUpdated = true;
+			});
+
+			vertex_change change;
+			if (isUpdated || !suffixHull.isFullDimensional()) {
+				std::vector<window_point> suffixVertices = suffixHull.vertices();
+				std::sort(suffixVertices.begin(), suffixVertices.end(), byLabel);
+				std::set_difference(suffixVertices.begin(), suffixVertices.end(), previousVertices.begin(), previousVertices.end(), std::back_inserter(change.added), byLabel);
+				std::set_difference(previousVertices.begin(), previousVertices.end(), suffixVertices.begin(), suffixVertices.end(), std::back_inserter(change.removed), byLabel);
+				previousVertices = std::move(suffixVertices);
+			}
+
+			m_front.push_back(std::move(change));
+		}
+
+		for (const window_point& theVertex : previousVertices) {
+			m_frontVertices.emplace(theVertex.label, theVertex);
+		}
+
+		// The graphs of both hulls are no longer needed, only the recorded vertices are
+		hullgraph::destroyGraph(suffixHull.vertex());
+		hullgraph::destroyGraph(m_backHull.vertex());
+		m_back.clear();
+		m_backHull = incremental_convex_hull<window_point>(m_options);
+		m_backHullSize = 0;
+	}
+
+public:
+	sliding_window_hull(const convex_hull_options& options = convex_hull_options()) : m_options(options), m_backHull(options) {}
+
+	/*
+	 * Destroys the graph of the hull of the back stack, see destroyGraph.
+	 */
+	~sliding_window_hull() {
+		hullgraph::destroyGraph(m_backHull.vertex());
+	}
+
+	/*
+	 * Adds a point at the back of the window and returns its sequence number.
+	 */
+	size_t push(const Point& thePoint) {
+		m_back.emplace_back(thePoint.x, thePoint.y, thePoint.z, m_nextSequenceNumber);
+		return m_nextSequenceNumber++;
+	}
+
+	/*
+	 * Removes the oldest point of the window, which shouldn't be empty.
+	 */
+	void pop() {
+		if (m_front.empty()) {
+			moveBackToFront();
+		}
+
+		for (const window_point& theVertex : m_front.back().added) {
+			m_frontVertices.erase(theVertex.label);
+		}
+		for (const window_point& theVertex : m_front.back().removed) {
+			m_frontVertices.emplace(theVertex.label, theVertex);
+		}
+
+		m_front.pop_back();
+	}
+
+	size_t size() const {
+		return m_front.size() + m_back.size();
+	}
+
+	bool empty() const {
+		return !size();
+	}
+
+	/*
+	 * Returns the sequence number of the oldest point of the window, which shouldn't be empty.
+	 */
+	size_t frontSequenceNumber() const {
+		return m_nextSequenceNumber - size();
+	}
+
+	/*
+	 * Computes the hull of the points in the window, with the sequence numbers of the points as
+	 * the indices, see computeConvexHull3DIndices.
+	 */
+	convex_hull_indices hullIndices() const {
+		if (m_backHullSize < m_back.size()) {
+			m_backHull.insert(std::vector<window_point>(m_back.begin() + m_backHullSize, m_back.end()));
+			m_backHullSize = m_back.size();
+		}
+
+		std::vector<window_point> candidates = m_backHull.vertices();
+		for (const auto& entry : m_frontVertices) {
+			candidates.push_back(entry.second);
+		}
+
+		return extractHullIndices(computeConvexHull3D(candidates, m_options), m_options.execution);
+	}
+};
@@ -0,0 +1,266 @@
+#include "../ConvexHull3D/convexhull3d.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Timings of the hull engines on inputs large enough for the differences between them to show.
+ * Run without arguments to run every benchmark, or with the names of the ones to run. Build it in
+ * the Release configuration, the Debug timings don't mean much.
+ */
+
+using namespace hullgraph;
+
+namespace {
+	std::atomic<size_t> allocationCount(0);
+}
+
+// Every allocation of the program is counted, so that the benchmarks can report them
+void* operator new(size_t size) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* block = std::malloc(size ? size : 1)) {
+		return block;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept {
+	std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+	std::free(block);
+}
+
+namespace {
+	/*
+	 * Returns the number of seconds the function takes.
+	 */
+	template<class Function>
+	double measureSeconds(Function function) {
+		auto start = std::chrono::steady_clock::now();
+		function();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	/*
+	 * Returns the number of allocations the function makes.
+	 */
+	template<class Function>
+	size_t countAllocations(Function function) {
+		size_t before = allocationCount.load();
+		function();
+		return allocationCount.load() - before;
+	}
+
+	/*
+	 * Returns a point uniformly distributed on the unit sphere.
+	 */
+	point<double> randomDirection(std::mt19937_64& randomEngine) {
+		std::normal_distribution<double> coordinateGen;
+		point<double> direction = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+		double length = std::sqrt(scalarProduct(direction, direction));
+		return { direction.x / length, direction.y / length, direction.z / length };
+	}
+
+	/*
+	 * Returns the number of vertices of a hull, then destroys its graph.
+	 */
+	template<class Point>
+	size_t countAndDestroy(const std::shared_ptr<vertex<Point>>& hullVertex) {
+		std::set<std::shared_ptr<vertex<Point>>> hullVertices;
+		for (const auto& theEdge : exploreGraph(hullVertex)) {
+			hullVertices.insert(theEdge->origin());
+		}
+
+		destroyGraph(hullVertex);
+		return hullVertices.size();
+	}
+
+	/*
+	 * Points uniformly distributed in a ball of radius 1/2, with a few points on the unit sphere
+	 * around it, so the hull has few vertices compared to the number of points. This is the case
+	 * computeConvexHull3DAutomatic is for.
+	 */
+	void benchmarkFewHullVertices() {
+		std::mt19937_64 randomEngine;
+		std::uniform_real_distribution<double> radiusGen(0, 1);
+
+		for (size_t pointCount : { 50000, 200000 }) {
+			std::vector<point<double>> pts;
+			for (size_t i = 0; i < pointCount; i++) {
+				point<double> direction = randomDirection(randomEngine);
+				double radius = std::cbrt(radiusGen(randomEngine)) / 2;
+				pts.push_back({ direction.x * radius, direction.y * radius, direction.z * radius });
+			}
+			for (size_t i = 0; i < 200; i++) {
+				pts.push_back(randomDirection(randomEngine));
+			}
+			std::shuffle(pts.begin(), pts.end(), randomEngine);
+
+			size_t hullSize = 0;
+			double exactSeconds = measureSeconds([&]() { hullSize = countAndDestroy(computeConvexHull3D(pts)); });
+			double automaticSeconds = measureSeconds([&]() { countAndDestroy(computeConvexHull3DAutomatic(pts)); });
+
+			std::cout << pts.size() << " points, " << hullSize << " hull vertices" << std::endl;
+			std::cout << "  computeConvexHull3D           " << exactSeconds << " s" << std::endl;
+			std::cout << "  computeConvexHull3DAutomatic  " << automaticSeconds << " s" << std::endl;
+		}
+	}
+
+	/*
+	 * Random points in a cube, with the stages which can run on several threads (the duplicate
+	 * pass, the extreme initial simplex and the conflict graph) on one thread and on all of them.
+	 */
+	void benchmarkParallelStages() {
+		std::mt19937_64 randomEngine;
+		std::uniform_int_distribution<long long> coordinateGen(-1000000, 1000000);
+		std::vector<point<long long>> pts(300000);
+		for (auto& thePoint : pts) {
+			thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+		}
+
+		convex_hull_options options;
+		options.extremeInitialSimplex = true;
+		options.removeDuplicates = true;
+		unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+		double sequentialSeconds = measureSeconds([&]() { countAndDestroy(computeConvexHull3D(sequentialExecution(), pts, options)); });
+		double parallelSeconds = measureSeconds([&]() { countAndDestroy(computeConvexHull3D(parallelExecution(), pts, options)); });
+
+		std::cout << pts.size() << " points" << std::endl;
+		std::cout << "  sequentialExecution  " << sequentialSeconds << " s" << std::endl;
+		std::cout << "  parallelExecution    " << parallelSeconds << " s on " << threadCount << " threads" << std::endl;
+	}
+
+	/*
+	 * Points on a paraboloid in sorted order, so the first four points are a sliver which almost
+	 * every other point is outside of, with and without the extreme initial simplex. The unit tests
+	 * only check the conflict lists on a smaller grid.
+	 */
+	void benchmarkSortedParaboloid() {
+		std::vector<point<long long>> pts;
+		for (long long i = 0; i < 200; i++) {
+			for (long long j = 0; j < 200; j++) {
+				pts.push_back({ i, j, i * i + j * j });
+			}
+		}
+
+		convex_hull_options options;
+		options.extremeInitialSimplex = true;
+		double plainSeconds = measureSeconds([&]() { countAndDestroy(computeConvexHull3D(pts)); });
+		double extremeSeconds = measureSeconds([&]() { countAndDestroy(computeConvexHull3D(pts, options)); });
+
+		std::cout << pts.size() << " points" << std::endl;
+		std::cout << "  first four points  " << plainSeconds << " s" << std::endl;
+		std::cout << "  extreme simplex    " << extremeSeconds << " s" << std::endl;
+	}
+
+	/*
+	 * Many small hulls of random points, in hulls per second, with a new workspace for every hull
+	 * and with one workspace reused for all of them. With the default options a reused workspace
+	 * doesn't allocate once it has grown to the size of the inputs.
+	 */
+	void benchmarkSmallHulls() {
+		std::mt19937_64 randomEngine;
+		std::uniform_int_distribution<long long> coordinateGen(-10000, 10000);
+
+		for (size_t pointCount : { 20, 100, 500 }) {
+			std::vector<std::vector<point<long long>>> pointSets(1000, std::vector<point<long long>>(pointCount));
+			for (auto& pts : pointSets) {
+				for (auto& thePoint : pts) {
+					thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+				}
+			}
+
+			hull_workspace<point<long long>> workspace;
+			double plainSeconds = measureSeconds([&]() {
+				for (const auto& pts : pointSets) {
+					destroyGraph(computeConvexHull3D(pts));
+				}
+			});
+			double workspaceSeconds = measureSeconds([&]() {
+				for (const auto& pts : pointSets) {
+					destroyGraph(computeConvexHull3D(workspace, pts));
+				}
+			});
+
+			size_t plainAllocations = countAllocations([&]() { destroyGraph(computeConvexHull3D(pointSets[0])); });
+			size_t workspaceAllocations = countAllocations([&]() { destroyGraph(computeConvexHull3D(workspace, pointSets[0])); });
+
+			std::cout << pointSets.size() << " sets of " << pointCount << " points" << std::endl;
+			std::cout << "  computeConvexHull3D              " << pointSets.size() / plainSeconds << " hulls/s, " << plainAllocations << " allocations per hull" << std::endl;
+			std::cout << "  computeConvexHull3D (workspace)  " << pointSets.size() / workspaceSeconds << " hulls/s, " << workspaceAllocations << " allocations per hull" << std::endl;
+		}
+	}
+
+	/*
+	 * Points on a sphere, which all end up on the hull, so the graph is as large as it gets and
+	 * every point goes through the whole insertion. Compares a hull without a workspace, which
+	 * takes its objects from the heap, with the same hull from a workspace which has already
+	 * computed it once, so that its pool holds all the objects it needs.
+	 */
+	void benchmarkSphereWorkspace() {
+		std::mt19937_64 randomEngine;
+		std::vector<point<double>> pts(50000);
+		for (auto& thePoint : pts) {
+			thePoint = randomDirection(randomEngine);
+		}
+
+		hull_workspace<point<double>> workspace;
+		countAndDestroy(computeConvexHull3D(workspace, pts));
+
+		size_t plainSize = 0, workspaceSize = 0, plainAllocations = 0, workspaceAllocations = 0;
+		double plainSeconds = measureSeconds([&]() {
+			plainAllocations = countAllocations([&]() { plainSize = countAndDestroy(computeConvexHull3D(pts)); });
+		});
+		double workspaceSeconds = measureSeconds([&]() {
+			workspaceAllocations = countAllocations([&]() { workspaceSize = countAndDestroy(computeConvexHull3D(workspace, pts)); });
+		});
+
+		std::cout << pts.size() << " points, " << plainSize << " hull vertices";
+		std::cout << (plainSize == workspaceSize ? "" : ", the hulls differ!") << std::endl;
+		std::cout << "  computeConvexHull3D              " << plainSeconds << " s, " << plainAllocations << " allocations" << std::endl;
+		std::cout << "  computeConvexHull3D (workspace)  " << workspaceSeconds << " s, " << workspaceAllocations << " allocations" << std::endl;
+	}
+
+	struct benchmark {
+		std::string name;
+		std::function<void()> run;
+	};
+
+	const std::vector<benchmark> benchmarks = {
+		{ "few-hull-vertices", benchmarkFewHullVertices },
+		{ "parallel-stages", benchmarkParallelStages },
+		{ "sorted-paraboloid", benchmarkSortedParaboloid },
+		{ "small-hulls", benchmarkSmallHulls },
+		{ "sphere-workspace", benchmarkSphereWorkspace },
+	};
+}
+
+int main(int argc, char** argv) {
+	for (const benchmark& theBenchmark : benchmarks) {
+		bool isSelected = argc == 1;
+		for (int i = 1; i < argc; i++) {
+			isSelected |= theBenchmark.name == argv[i];
+		}
+
+		if (isSelected) {
+			std::cout << "== " << theBenchmark.name << std::endl;
+			theBenchmark.run();
+		}
+	}
+
+	return 0;
+}
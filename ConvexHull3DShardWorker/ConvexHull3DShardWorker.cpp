@@ -0,0 +1,11 @@
+#include "../ConvexHull3D/convexhull3d.h"
+
+/*
+ * The worker process of computeConvexHull3DSharded for point files of double coordinates, started
+ * by process_shard_launcher with the path of the file, the first point and the number of points
+ * of its shard. It writes the vertices of the hull of the shard to its standard output, see
+ * runShardWorker.
+ */
+int main(int argc, char** argv) {
+	return runShardWorker<double>(argc, argv);
+}
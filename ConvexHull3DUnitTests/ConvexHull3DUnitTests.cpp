@@ -1,8 +1,14 @@
 #include "pch.h"
 #include "CppUnitTest.h"
-#include "../ConvexHull3D/voronoi.h"
 
+#include "../ConvexHull3D/convexhull3d.h"
+
+#include <filesystem>
+#include <fstream>
+#include <map>
 #include <set>
+#include <sstream>
+#include <thread>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace hullgraph;
@@ -118,6 +124,18 @@ namespace ConvexHull3DUnitTests {
 			Assert::AreEqual(2, (int)faceToEdgeList(bridge->twin()->incidentFace()).size());
 		}
 
+		TEST_METHOD(SplitFaceCompilesAndAppearsToWork) {
+			auto f = makePolygon(std::vector<int>{ 0, 1, 2, 3, 4 });
+			auto edges = faceToEdgeList(f);
+			auto diagonal = splitFace(edges[1], edges[3]);
+
+			Assert::AreEqual(3, diagonal->origin()->data());
+			Assert::AreEqual(1, diagonal->destination()->data());
+			Assert::AreEqual(3, (int)faceToEdgeList(diagonal->incidentFace()).size());
+			Assert::AreEqual(4, (int)faceToEdgeList(diagonal->twin()->incidentFace()).size());
+			Assert::AreEqual(12, (int)exploreGraph(diagonal->origin()).size());
+		}
+
 		TEST_METHOD(ExploreGraphCompilesAndAppearsToWork) {
 			auto f = makeTriangle(0, 1, 2);
 			auto newPoint = inscribeVertex(f, 3);
@@ -299,45 +317,2471 @@ namespace ConvexHull3DUnitTests {
 		}
 	};
 
-	TEST_CLASS(DelaunayTriangulationTests) {
+	TEST_CLASS(TriangulatedHullTests) {
 	public:
 
-		TEST_METHOD(IsFaceDirectedUpTest1) {
-			std::vector<point<int>> pts = { {0, 0, 0}, {10, 0, 0}, {10, 0, 10} };
-			auto triangle = makePolygon(pts);
-			Assert::IsTrue(isFaceDirectedUpOrVertical(triangle));
+		template<class Point>
+		static void assertTriangleMesh(const std::shared_ptr<vertex<Point>>& hullVertex) {
+			auto allEdges = exploreGraph(hullVertex);
+			std::set<std::shared_ptr<face<Point>>> faces;
+			std::set<Point> vertices;
+
+			for (const auto& theEdge : allEdges) {
+				auto faceEdges = faceToEdgeList(theEdge->incidentFace());
+				Assert::AreEqual(3, (int)faceEdges.size());
+				Assert::IsFalse(collinear(faceEdges[0]->origin()->data(), faceEdges[1]->origin()->data(), faceEdges[2]->origin()->data()));
+				faces.insert(theEdge->incidentFace());
+				vertices.insert(theEdge->origin()->data());
+			}
+
+			Assert::AreEqual(2, (int)vertices.size() - (int)allEdges.size() / 2 + (int)faces.size());
 		}
 
-		TEST_METHOD(IsFaceDirectedUpTest2) {
-			std::vector<point<int>> pts = { {0, 0, 0}, {10, 0, 0}, {10, 1, 10} };
-			auto triangle = makePolygon(pts);
-			Assert::IsTrue(isFaceDirectedUpOrVertical(triangle));
+		TEST_METHOD(TriangulatedHullCubeLattice) {
+			std::vector<point<int>> pts;
+
+			for (int i = 0; i < 6; i++) {
+				for (int j = 0; j < 6; j++) {
+					for (int k = 0; k < 6; k++) {
+						pts.push_back({ i, j, k });
+					}
+				}
+			}
+
+			convex_hull_options options;
+			options.triangulate = true;
+
+			for (size_t repetition = 0; repetition < 20; repetition++) {
+				assertTriangleMesh(computeConvexHull3D(pts, options));
+			}
 		}
 
-		TEST_METHOD(IsFaceDirectedUpTest3) {
-			std::vector<point<int>> pts = { {0, 0, 0}, {10, 0, 0}, {10, -1, 10} };
-			auto triangle = makePolygon(pts);
-			Assert::IsFalse(isFaceDirectedUpOrVertical(triangle));
+		TEST_METHOD(TriangulatedHullSphere) {
+			const int numPoints = 1000;
+			std::vector<point<double>> pts(numPoints);
+			std::mt19937_64 randomEngine;
+			std::normal_distribution<double> coordinateGen;
+
+			for (auto& thePoint : pts) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+				double norm = sqrt(scalarProduct(thePoint, thePoint));
+				thePoint = { thePoint.x / norm, thePoint.y / norm, thePoint.z / norm };
+			}
+
+			convex_hull_options options;
+			options.triangulate = true;
+			auto hullVertex = computeConvexHull3D(pts, options);
+
+			assertTriangleMesh(hullVertex);
+			Assert::AreEqual(6 * numPoints - 12, (int)exploreGraph(hullVertex).size());
 		}
 
-		TEST_METHOD(DelaunayTriangulationBasicTest1) {
-			std::vector<point<int>> pts = { {0, 0}, {0, 10}, {10, 0}, {6, 6} };
-			auto extFace = delaunayTriangulation(pts);
-			Assert::AreEqual(4, (int)faceToEdgeList(extFace).size());
+		TEST_METHOD(TriangulatedHullPlanar) {
+			std::vector<point<int>> pts = { {0, 0, 0}, {0, 0, 10}, {0, 10, 0}, {0, 10, 10}, {0, 5, 5}, {0, 13, 5}, {0, 0, 5} };
+			convex_hull_options options;
+			options.triangulate = true;
+			auto hullVertex = computeConvexHull3D(pts, options);
 
-			std::pair<size_t, size_t> expectedEdges[] = { {0, 1}, {0, 2}, {0, 3}, {1, 3}, {2, 3} };
-			std::set<std::pair<size_t, size_t>> actualEdges;
+			assertTriangleMesh(hullVertex);
+		}
+	};
 
-			for (const auto& theEdge : exploreGraph(extFace->outerComponent()->origin())) {
-				size_t u = theEdge->origin()->data().label;
-				size_t v = theEdge->destination()->data().label;
-			
-				if (u < v) {
-					actualEdges.insert({ u, v });
+	TEST_CLASS(IncrementalHullTests) {
+	public:
+
+		TEST_METHOD(IncrementalHullCubeLatticeOneByOne) {
+			incremental_convex_hull<point<int>> hull;
+
+			for (int i = 0; i < 6; i++) {
+				for (int j = 0; j < 6; j++) {
+					for (int k = 0; k < 6; k++) {
+						hull.insert(point<int>{ i, j, k });
+					}
 				}
 			}
 
-			Assert::IsTrue(actualEdges == std::set<std::pair<size_t, size_t>>(std::begin(expectedEdges), std::end(expectedEdges)));
+			Assert::IsTrue(hull.isFullDimensional());
+			Assert::AreEqual(24, (int)exploreGraph(hull.vertex()).size());
+		}
+
+		TEST_METHOD(IncrementalHullSphereInBatches) {
+			const int numPoints = 1000;
+			const int batchSize = 100;
+			const double pi = acos(double(-1));
+
+			std::mt19937_64 randomEngine;
+			std::uniform_real_distribution<double> angleGen(0, pi);
+			incremental_convex_hull<point<double>> hull;
+
+			for (int batch = 0; batch < numPoints / batchSize; batch++) {
+				std::vector<point<double>> pts(batchSize);
+				for (int i = 0; i < batchSize; i++) {
+					double phi = 2 * angleGen(randomEngine);
+					double theta = angleGen(randomEngine) - pi / 2;
+					pts[i] = { cos(phi) * cos(theta), sin(phi) * cos(theta), sin(theta) };
+				}
+
+				hull.insert(pts);
+				Assert::AreEqual(6 * (batch + 1) * batchSize - 12, (int)exploreGraph(hull.vertex()).size());
+			}
+		}
+
+		TEST_METHOD(IncrementalHullPlanarThenSpatial) {
+			incremental_convex_hull<point<int>> hull;
+
+			hull.insert(point<int>{ 0, 0, 0 });
+			hull.insert(point<int>{ 10, 0, 0 });
+			Assert::IsFalse(!!hull.vertex());
+
+			hull.insert(std::vector<point<int>>{ { 0, 10, 0 }, { 10, 10, 0 }, { 5, 5, 0 } });
+			Assert::IsFalse(hull.isFullDimensional());
+			Assert::AreEqual(4, (int)faceToEdgeList(hull.vertex()->incidentEdge()->incidentFace()).size());
+
+			hull.insert(point<int>{ 5, 5, 10 });
+			Assert::IsTrue(hull.isFullDimensional());
+			Assert::AreEqual(16, (int)exploreGraph(hull.vertex()).size());
+		}
+
+		TEST_METHOD(IncrementalHullIgnoresInsidePoints) {
+			incremental_convex_hull<point<int>> hull;
+			hull.insert(std::vector<point<int>>{ { 0, 0, 0 }, { 10, 0, 0 }, { 0, 10, 0 }, { 0, 0, 10 } });
+			auto hullVertex = hull.vertex();
+
+			hull.insert(point<int>{ 1, 1, 1 });
+			hull.insert(point<int>{ 2, 2, 2 });
+
+			Assert::IsTrue(hullVertex == hull.vertex());
+			Assert::AreEqual(12, (int)exploreGraph(hull.vertex()).size());
+		}
+
+		TEST_METHOD(IncrementalHullSinglePointsAreLocated) {
+			const double pi = acos(double(-1));
+			std::mt19937_64 randomEngine;
+			std::uniform_real_distribution<double> angleGen(0, pi);
+			auto spherePoint = [&](double radius) {
+				double phi = 2 * angleGen(randomEngine);
+				double theta = angleGen(randomEngine) - pi / 2;
+				return point<double>{ radius * cos(phi) * cos(theta), radius * sin(phi) * cos(theta), radius * sin(theta) };
+			};
+
+			std::vector<point<double>> pts(2000);
+			for (auto& thePoint : pts) {
+				thePoint = spherePoint(1);
+			}
+
+			incremental_convex_hull<point<double>> hull;
+			hull.insert(pts);
+
+			// Each point is found by walking over a few faces, not by testing all 4000 of them
+			for (int i = 0; i < 20; i++) {
+				pts.push_back(spherePoint(i % 2 ? 0.5 : 1.001));
+				size_t testsBefore = hull.statistics().orientationTests;
+				hull.insert(pts.back());
+				Assert::IsTrue(hull.statistics().orientationTests - testsBefore < 200);
+			}
+
+			auto expectedVertex = computeConvexHull3D(pts);
+			Assert::AreEqual(exploreGraph(expectedVertex).size(), exploreGraph(hull.vertex()).size());
+			destroyGraph(expectedVertex);
+			destroyGraph(hull.vertex());
+		}
+
+		TEST_METHOD(IncrementalHullReplacesPlanarGraph) {
+			incremental_convex_hull<point<int>> hull;
+			hull.insert(std::vector<point<int>>{ { 0, 0, 0 }, { 10, 0, 0 }, { 0, 10, 0 } });
+			std::weak_ptr<edge<point<int>>> firstPolygonEdge = hull.vertex()->incidentEdge();
+
+			hull.insert(point<int>{ 10, 10, 0 });
+			Assert::IsTrue(firstPolygonEdge.expired());
+			std::weak_ptr<edge<point<int>>> secondPolygonEdge = hull.vertex()->incidentEdge();
+
+			hull.insert(point<int>{ 5, 5, 10 });
+			Assert::IsTrue(secondPolygonEdge.expired());
+			Assert::IsTrue(hull.isFullDimensional());
+			destroyGraph(hull.vertex());
+		}
+	};
+
+	TEST_CLASS(DynamicHullTests) {
+	public:
+
+		template<class Point>
+		static std::set<std::tuple<int, int, int>> hullVertexSet(const std::shared_ptr<vertex<Point>>& hullVertex) {
+			std::set<std::tuple<int, int, int>> result;
+			for (const auto& theEdge : exploreGraph(hullVertex)) {
+				const auto& thePoint = theEdge->origin()->data();
+				result.insert({ thePoint.x, thePoint.y, thePoint.z });
+			}
+			return result;
+		}
+
+		TEST_METHOD(DynamicHullMatchesRecomputation) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<int> coordinateGen(0, 20);
+			dynamic_convex_hull<int> hull;
+			std::vector<point<int>> pts;
+			std::vector<size_t> ids;
+
+			for (int i = 0; i < 300; i++) {
+				pts.push_back({ coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) });
+				ids.push_back(hull.insert(pts.back()));
+			}
+
+			std::shuffle(ids.begin(), ids.end(), randomEngine);
+
+			for (size_t i = 0; i < ids.size(); i++) {
+				Assert::IsTrue(hull.erase(ids[i]));
+
+				if (i % 10 == 0) {
+					std::vector<point<int>> remainingPoints;
+					for (size_t j = i + 1; j < ids.size(); j++) {
+						remainingPoints.push_back(pts[ids[j]]);
+					}
+
+					auto expectedVertex = computeConvexHull3D(remainingPoints);
+					Assert::IsTrue(hull.vertex() ? !!expectedVertex : !expectedVertex);
+					if (expectedVertex) {
+						Assert::IsTrue(hullVertexSet(expectedVertex) == hullVertexSet(hull.vertex()));
+					}
+				}
+			}
+
+			Assert::AreEqual(0, (int)hull.size());
+			Assert::IsFalse(!!hull.vertex());
+		}
+
+		TEST_METHOD(DynamicHullInteriorEraseKeepsHull) {
+			dynamic_convex_hull<int> hull;
+			std::vector<size_t> interiorIds;
+
+			for (int i = 0; i < 8; i++) {
+				hull.insert(point<int>{ (i & 1) * 10, (i >> 1 & 1) * 10, (i >> 2) * 10 });
+			}
+
+			for (int i = 1; i < 10; i++) {
+				interiorIds.push_back(hull.insert(point<int>{ i, i, 10 - i }));
+			}
+
+			auto hullVertex = hull.vertex();
+			for (size_t id : interiorIds) {
+				Assert::IsTrue(hull.erase(id));
+			}
+
+			Assert::IsTrue(hullVertex == hull.vertex());
+			Assert::IsFalse(hull.erase(interiorIds[0]));
+			Assert::AreEqual(24, (int)exploreGraph(hull.vertex()).size());
+		}
+
+		TEST_METHOD(DynamicHullBecomesPlanar) {
+			dynamic_convex_hull<int> hull;
+			hull.insert(point<int>{ 0, 0, 0 });
+			hull.insert(point<int>{ 10, 0, 0 });
+			hull.insert(point<int>{ 0, 10, 0 });
+			hull.insert(point<int>{ 3, 3, 0 });
+			size_t apexId = hull.insert(point<int>{ 0, 0, 10 });
+
+			Assert::AreEqual(12, (int)exploreGraph(hull.vertex()).size());
+
+			hull.erase(apexId);
+			Assert::AreEqual(3, (int)faceToEdgeList(hull.vertex()->incidentEdge()->incidentFace()).size());
+
+			hull.insert(point<int>{ 1, 1, -10 });
+			Assert::AreEqual(12, (int)exploreGraph(hull.vertex()).size());
+		}
+
+		TEST_METHOD(DynamicHullFreesReplacedGraphs) {
+			std::weak_ptr<edge<dynamic_convex_hull<int>::hull_point>> firstEdge, secondEdge;
+			{
+				dynamic_convex_hull<int> hull;
+				std::vector<size_t> ids;
+				for (int i = 0; i < 8; i++) {
+					ids.push_back(hull.insert(point<int>{ (i & 1) * 10, (i >> 1 & 1) * 10, (i >> 2) * 10 }));
+				}
+
+				// The edges of the erased corner go away, the ones of the opposite corner stay
+				std::weak_ptr<edge<dynamic_convex_hull<int>::hull_point>> farEdge;
+				for (const auto& theEdge : exploreGraph(hull.vertex())) {
+					if (theEdge->origin()->data().label == ids[0]) {
+						firstEdge = theEdge;
+					}
+					if (theEdge->origin()->data().label == ids[7]) {
+						farEdge = theEdge;
+					}
+				}
+
+				hull.erase(ids[0]);
+				Assert::IsTrue(firstEdge.expired());
+				Assert::IsFalse(farEdge.expired());
+				Assert::IsTrue(!!farEdge.lock()->origin());
+				Assert::AreEqual(7, (int)hullVertexSet(hull.vertex()).size());
+
+				secondEdge = hull.vertex()->incidentEdge();
+				Assert::IsFalse(secondEdge.expired());
+			}
+
+			Assert::IsTrue(secondEdge.expired());
+		}
+
+		TEST_METHOD(DynamicHullRepairsAroundErasedVertices) {
+			std::mt19937_64 randomEngine;
+			std::normal_distribution<double> coordinateGen;
+			dynamic_convex_hull<double> hull;
+			std::vector<point<double>> pts;
+			std::vector<size_t> ids;
+
+			// Points on a sphere, and as many inside of it
+			for (int i = 0; i < 2000; i++) {
+				point<double> thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+				double scale = (i % 2 ? 0.9 : 1.0) / std::sqrt(scalarProduct(thePoint, thePoint));
+				pts.push_back({ thePoint.x * scale, thePoint.y * scale, thePoint.z * scale });
+				ids.push_back(hull.insert(pts.back()));
+			}
+
+			std::weak_ptr<edge<dynamic_convex_hull<double>::hull_point>> farEdge;
+			for (const auto& theEdge : exploreGraph(hull.vertex())) {
+				if (theEdge->origin()->data().z < -0.8) {
+					farEdge = theEdge;
+				}
+			}
+
+			// Erasing the points near the top pole only changes the graph there
+			std::vector<bool> erased(pts.size(), false);
+			for (size_t i = 0; i < pts.size(); i++) {
+				if (pts[i].z > 0.5) {
+					Assert::IsTrue(hull.erase(ids[i]));
+					erased[i] = true;
+				}
+			}
+
+			Assert::IsFalse(farEdge.expired());
+			Assert::IsTrue(!!farEdge.lock()->origin());
+
+			std::vector<point<double>> remainingPoints;
+			for (size_t i = 0; i < pts.size(); i++) {
+				if (!erased[i]) {
+					remainingPoints.push_back(pts[i]);
+				}
+			}
+
+			auto expectedVertex = computeConvexHull3D(remainingPoints);
+			std::set<point<double>> expectedVertices, actualVertices;
+			for (const auto& theEdge : exploreGraph(expectedVertex)) {
+				expectedVertices.insert(theEdge->origin()->data());
+			}
+			for (const auto& theEdge : exploreGraph(hull.vertex())) {
+				const auto& thePoint = theEdge->origin()->data();
+				actualVertices.insert({ thePoint.x, thePoint.y, thePoint.z });
+			}
+
+			Assert::IsTrue(expectedVertices == actualVertices);
+			destroyGraph(expectedVertex);
+		}
+	};
+
+	TEST_CLASS(StreamingHullTests) {
+	public:
+
+		TEST_METHOD(StreamingHullMatchesInMemoryHull) {
+			const int numPoints = 2000;
+			std::mt19937_64 randomEngine;
+			std::normal_distribution<double> coordinateGen;
+			std::vector<point<double>> pts(numPoints);
+
+			for (auto& thePoint : pts) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+			}
+
+			size_t position = 0;
+			auto source = [&](point<double>* buffer, size_t maxCount) {
+				size_t count = std::min(maxCount, pts.size() - position);
+				std::copy(pts.begin() + position, pts.begin() + position + count, buffer);
+				position += count;
+				return count;
+			};
+
+			auto streamedVertex = computeConvexHull3DStreaming<point<double>>(source, 128);
+			auto expectedVertex = computeConvexHull3D(pts);
+
+			std::set<point<double>> streamedPoints, expectedPoints;
+			for (const auto& theEdge : exploreGraph(streamedVertex)) {
+				streamedPoints.insert(theEdge->origin()->data());
+			}
+			for (const auto& theEdge : exploreGraph(expectedVertex)) {
+				expectedPoints.insert(theEdge->origin()->data());
+			}
+
+			Assert::AreEqual(exploreGraph(expectedVertex).size(), exploreGraph(streamedVertex).size());
+			Assert::IsTrue(streamedPoints == expectedPoints);
+		}
+
+		TEST_METHOD(StreamingHullFromBinaryStream) {
+			std::stringstream stream;
+			for (int i = 0; i < 6; i++) {
+				for (int j = 0; j < 6; j++) {
+					for (int k = 0; k < 6; k++) {
+						point<int> thePoint = { i, j, k };
+						stream.write(reinterpret_cast<const char*>(&thePoint), sizeof(thePoint));
+					}
+				}
+			}
+
+			auto hullVertex = computeConvexHull3DFromStream<int>(stream, 10);
+			Assert::AreEqual(24, (int)exploreGraph(hullVertex).size());
+		}
+
+		TEST_METHOD(StreamingHullRejectsBadInput) {
+			std::stringstream stream;
+			for (int i = 0; i < 8; i++) {
+				point<int> thePoint = { i & 1, i >> 1 & 1, i >> 2 };
+				stream.write(reinterpret_cast<const char*>(&thePoint), sizeof(thePoint));
+			}
+
+			// Half of a ninth point
+			stream.write("\0\0\0\0\0\0", 6);
+
+			Assert::ExpectException<std::runtime_error>([&]() { computeConvexHull3DFromStream<int>(stream, 3); });
+			Assert::ExpectException<std::invalid_argument>([&]() { computeConvexHull3DFromStream<int>(stream, 0); });
+		}
+
+		TEST_METHOD(StreamingHullStopsReadingWhenCancelled) {
+			std::atomic<bool> cancelled{ true };
+			convex_hull_options options;
+			options.cancellationToken = &cancelled;
+
+			int chunksRead = 0;
+			auto source = [&](point<int>* buffer, size_t maxCount) {
+				chunksRead++;
+				for (size_t i = 0; i < maxCount; i++) {
+					buffer[i] = { int(i % 7), int(i % 11), int(i % 13) };
+				}
+				return maxCount;
+			};
+
+			// The source never ends, the hull of the first chunk is returned
+			auto hullVertex = computeConvexHull3DStreaming<point<int>>(source, 100, options);
+			Assert::AreEqual(1, chunksRead);
+			Assert::IsTrue(!!hullVertex);
+			destroyGraph(hullVertex);
+		}
+	};
+
+	TEST_CLASS(ToleranceHullTests) {
+	public:
+
+		static int countFaces(const std::shared_ptr<vertex<point<double>>>& hullVertex) {
+			std::set<std::shared_ptr<face<point<double>>>> faces;
+			for (const auto& theEdge : exploreGraph(hullVertex)) {
+				faces.insert(theEdge->incidentFace());
+			}
+
+			return (int)faces.size();
+		}
+
+		// Returns how far the farthest point lies outside of the hull, measured from the best fitting
+		// plane of each face, as the faces are only roughly planar
+		static double maxDistanceOutside(const std::shared_ptr<vertex<point<double>>>& hullVertex, const std::vector<point<double>>& pts) {
+			std::set<std::shared_ptr<face<point<double>>>> faces;
+			double maxDistance = 0;
+
+			for (const auto& theEdge : exploreGraph(hullVertex)) {
+				if (!faces.insert(theEdge->incidentFace()).second) {
+					continue;
+				}
+
+				auto faceEdges = faceToEdgeList(theEdge->incidentFace());
+				point<double> origin = faceEdges[0]->origin()->data();
+				point<double> normal = { 0, 0, 0 };
+				for (const auto& faceEdge : faceEdges) {
+					auto product = vectorProduct(faceEdge->origin()->data() - origin, faceEdge->destination()->data() - origin);
+					normal = { normal.x + product.x, normal.y + product.y, normal.z + product.z };
+				}
+
+				double normalLength = std::sqrt(scalarProduct(normal, normal));
+				for (const auto& thePoint : pts) {
+					maxDistance = std::max(maxDistance, scalarProduct(normal, thePoint - origin) / normalLength);
+				}
+			}
+
+			return maxDistance;
+		}
+
+		TEST_METHOD(ToleranceHullMergesNoisyPlane) {
+			std::mt19937_64 randomEngine;
+			std::uniform_real_distribution<double> noiseGen(-1e-9, 1e-9);
+			std::vector<point<double>> pts;
+
+			for (int i = 0; i < 30; i++) {
+				for (int j = 0; j < 30; j++) {
+					pts.push_back({ i + noiseGen(randomEngine), j + noiseGen(randomEngine), noiseGen(randomEngine) });
+				}
+			}
+			pts.push_back({ 15, 15, 10 });
+
+			convex_hull_options options;
+			options.coplanarityTolerance = 1e-6;
+			auto hullVertex = computeConvexHull3D(pts, options);
+
+			Assert::IsTrue(countFaces(computeConvexHull3D(pts)) > 20);
+			Assert::AreEqual(5, countFaces(hullVertex));
+			Assert::IsTrue(maxDistanceOutside(hullVertex, pts) < 1e-5);
+
+			// The merge doesn't depend on the order of the points
+			std::shuffle(pts.begin(), pts.end(), randomEngine);
+			Assert::AreEqual(5, countFaces(computeConvexHull3D(pts, options)));
+		}
+
+		TEST_METHOD(ToleranceHullNoisyCubeInBatches) {
+			std::mt19937_64 randomEngine;
+			std::uniform_real_distribution<double> noiseGen(-1e-9, 1e-9);
+			std::vector<point<double>> pts;
+
+			for (int i = 0; i <= 10; i++) {
+				for (int j = 0; j <= 10; j++) {
+					for (int k = 0; k <= 10; k++) {
+						if (i % 10 && j % 10 && k % 10) {
+							continue;
+						}
+
+						pts.push_back({ i + noiseGen(randomEngine), j + noiseGen(randomEngine), k + noiseGen(randomEngine) });
+					}
+				}
+			}
+			std::shuffle(pts.begin(), pts.end(), randomEngine);
+
+			convex_hull_options options;
+			options.coplanarityTolerance = 1e-6;
+			incremental_convex_hull<point<double>> hull(options);
+			for (size_t i = 0; i < pts.size(); i += 100) {
+				hull.insert(std::vector<point<double>>(pts.begin() + i, pts.begin() + std::min(pts.size(), i + 100)));
+			}
+
+			Assert::IsTrue(countFaces(computeConvexHull3D(pts)) > 100);
+			Assert::AreEqual(6, countFaces(hull.vertex()));
+			Assert::IsTrue(maxDistanceOutside(hull.vertex(), pts) < 1e-5);
+		}
+
+		TEST_METHOD(ToleranceHullInsertKeepsUntouchedFaces) {
+			std::mt19937_64 randomEngine;
+			std::uniform_real_distribution<double> noiseGen(-1e-9, 1e-9);
+			std::vector<point<double>> pts;
+
+			for (int i = 0; i <= 10; i++) {
+				for (int j = 0; j <= 10; j++) {
+					for (int k = 0; k <= 10; k++) {
+						if (i % 10 && j % 10 && k % 10) {
+							continue;
+						}
+
+						pts.push_back({ i + noiseGen(randomEngine), j + noiseGen(randomEngine), k + noiseGen(randomEngine) });
+					}
+				}
+			}
+
+			convex_hull_options options;
+			options.coplanarityTolerance = 1e-6;
+			incremental_convex_hull<point<double>> hull(options);
+			hull.insert(pts);
+			Assert::AreEqual(6, countFaces(hull.vertex()));
+
+			// A point above the top face only replaces that face
+			std::vector<std::weak_ptr<face<point<double>>>> otherFaces;
+			for (const auto& theEdge : exploreGraph(hull.vertex())) {
+				auto theFace = theEdge->incidentFace();
+				bool isTop = true;
+				for (const auto& faceEdge : faceToEdgeList(theFace)) {
+					isTop &= faceEdge->origin()->data().z > 9;
+				}
+
+				if (theFace->outerComponent() == theEdge && !isTop) {
+					otherFaces.push_back(theFace);
+				}
+			}
+
+			pts.push_back({ 5, 5, 12 });
+			hull.insert(pts.back());
+			Assert::AreEqual(5, (int)otherFaces.size());
+			for (const auto& sideFace : otherFaces) {
+				Assert::IsFalse(sideFace.expired());
+				Assert::IsTrue(!!sideFace.lock()->outerComponent());
+			}
+
+			Assert::IsTrue(countFaces(hull.vertex()) > 6);
+			Assert::IsTrue(maxDistanceOutside(hull.vertex(), pts) < 1e-5);
+
+			// Points within the tolerance of the hull don't change it
+			int faceCount = countFaces(hull.vertex());
+			hull.insert(point<double>{ 0.5, 0.5, 1e-7 });
+			Assert::AreEqual(faceCount, countFaces(hull.vertex()));
+			destroyGraph(hull.vertex());
+		}
+	};
+
+	TEST_CLASS(ApproximateHullTests) {
+	public:
+
+		TEST_METHOD(ApproximateHullWithinErrorBound) {
+			const int numPoints = 20000;
+			std::mt19937_64 randomEngine;
+			std::normal_distribution<double> coordinateGen;
+			std::vector<point<double>> pts(numPoints);
+
+			for (auto& thePoint : pts) {
+				thePoint = { 3 * coordinateGen(randomEngine), 2 * coordinateGen(randomEngine), coordinateGen(randomEngine) };
+			}
+
+			auto result = computeApproximateConvexHull3D(pts, 0.2, 4);
+			Assert::IsTrue(result.kernelSize < numPoints / 20);
+			Assert::IsTrue(result.errorBound > 0);
+
+			// No point lies farther than the bound outside of any face
+			std::set<std::shared_ptr<face<point<double>>>> faces;
+			for (const auto& theEdge : exploreGraph(result.vertex)) {
+				if (!faces.insert(theEdge->incidentFace()).second) {
+					continue;
+				}
+
+				for (const auto& thePoint : pts) {
+					Assert::IsTrue(facePointDistance(theEdge->incidentFace(), thePoint) <= result.errorBound);
+				}
+			}
+		}
+
+		TEST_METHOD(ApproximateHullKeepsRelativeWidth) {
+			std::mt19937_64 randomEngine;
+			std::normal_distribution<double> coordinateGen;
+			std::vector<point<double>> pts(20000);
+
+			// A thin slab, tilted so that it is not aligned with the axes
+			for (auto& thePoint : pts) {
+				double a = 1000 * coordinateGen(randomEngine), b = 500 * coordinateGen(randomEngine), c = 0.01 * coordinateGen(randomEngine);
+				thePoint = { a + c, b - c, a + b + c };
+			}
+
+			const double epsilon = 0.1;
+			auto kernel = computeEpsilonKernel(pts, epsilon, 4);
+			Assert::IsTrue(kernel.points.size() < pts.size() / 10);
+
+			auto width = [](const std::vector<point<double>>& points, const point<double>& direction) {
+				double lowest = std::numeric_limits<double>::infinity(), highest = -lowest;
+				for (const auto& thePoint : points) {
+					lowest = std::min(lowest, scalarProduct(direction, thePoint));
+					highest = std::max(highest, scalarProduct(direction, thePoint));
+				}
+
+				return highest - lowest;
+			};
+
+			// Across the slab as well as along it
+			std::vector<point<double>> directions = { { 1, -1, 0 }, { 1, 1, -1 }, { 1, 0, 0 }, { 0, 0, 1 } };
+			for (int i = 0; i < 100; i++) {
+				directions.push_back({ coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) });
+			}
+
+			for (const auto& direction : directions) {
+				Assert::IsTrue(width(kernel.points, direction) >= (1 - epsilon) * width(pts, direction));
+			}
+		}
+
+		TEST_METHOD(ApproximateHullKeepsAllPointsWithoutEpsilon) {
+			std::vector<point<int>> pts;
+			for (int i = 0; i < 6; i++) {
+				for (int j = 0; j < 6; j++) {
+					for (int k = 0; k < 6; k++) {
+						pts.push_back({ i, j, k });
+					}
+				}
+			}
+
+			auto kernel = computeEpsilonKernel(pts, 0);
+			Assert::AreEqual(pts.size(), kernel.points.size());
+			Assert::AreEqual(0.0, kernel.errorBound);
+
+			auto result = computeApproximateConvexHull3D(pts, 0.01);
+			Assert::AreEqual(24, (int)exploreGraph(result.vertex).size());
+		}
+
+		TEST_METHOD(ApproximateHullFromPointSource) {
+			std::mt19937_64 randomEngine;
+			std::normal_distribution<double> coordinateGen;
+			std::vector<point<double>> pts(2000);
+			std::vector<double> interleaved;
+
+			for (auto& thePoint : pts) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+				interleaved.insert(interleaved.end(), { thePoint.x, thePoint.y, thePoint.z });
+			}
+
+			strided_point_source<double> strided = { interleaved.data(), pts.size(), 3 };
+			auto kernel = computeEpsilonKernel(strided, 0.1, 2);
+			Assert::IsTrue(kernel.points == computeEpsilonKernel(pts, 0.1).points);
+
+			convex_hull_options options;
+			options.triangulate = true;
+			options.execution = 2;
+			auto result = computeApproximateConvexHull3D(strided, 0.1, options);
+			Assert::AreEqual(kernel.points.size(), result.kernelSize);
+
+			// Every face of a triangulated hull has three edges
+			for (const auto& theEdge : exploreGraph(result.vertex)) {
+				Assert::IsTrue(theEdge->next()->next()->next() == theEdge);
+			}
+		}
+	};
+
+	TEST_CLASS(AutomaticHullTests) {
+	public:
+
+		TEST_METHOD(AutomaticHullCubeLattice) {
+			// Enough points for the sample test, with most of the hull points on the faces
+			std::vector<point<int>> pts;
+			for (int i = 0; i < 21; i++) {
+				for (int j = 0; j < 21; j++) {
+					for (int k = 0; k < 21; k++) {
+						pts.push_back({ i, j, k });
+					}
+				}
+			}
+
+			auto hullVertex = computeConvexHull3DAutomatic(pts);
+			Assert::AreEqual(24, (int)exploreGraph(hullVertex).size());
+		}
+
+		TEST_METHOD(AutomaticHullMatchesHull) {
+			const int numPoints = 9000;
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<int> coordinateGen(-100, 100);
+			std::vector<point<int>> pts(numPoints);
+
+			for (auto& thePoint : pts) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) / 4 };
+			}
+			pts.push_back({ 0, 0, 200 });
+			pts.push_back({ 0, 0, -200 });
+
+			std::set<point<int>> expectedPoints, automaticPoints;
+			for (const auto& theEdge : exploreGraph(computeConvexHull3D(pts))) {
+				expectedPoints.insert(theEdge->origin()->data());
+			}
+			for (const auto& theEdge : exploreGraph(computeConvexHull3DAutomatic(pts))) {
+				automaticPoints.insert(theEdge->origin()->data());
+			}
+
+			Assert::IsTrue(expectedPoints == automaticPoints);
+		}
+
+		TEST_METHOD(AutomaticHullDropsInsidePoints) {
+			std::mt19937_64 randomEngine;
+			std::uniform_real_distribution<double> coordinateGen(-1, 1);
+			std::vector<double> coordinates;
+
+			// A cube of points with a few points on a larger sphere around it
+			for (int i = 0; i < 10000; i++) {
+				coordinates.insert(coordinates.end(), { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) });
+			}
+			for (int i = 0; i < 50; i++) {
+				point<double> direction = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+				double scale = 3 / std::sqrt(scalarProduct(direction, direction));
+				coordinates.insert(coordinates.end(), { direction.x * scale, direction.y * scale, direction.z * scale });
+			}
+
+			strided_point_source<double> pts = { coordinates.data(), coordinates.size() / 3, 3 };
+			std::set<point<double>> expectedPoints, automaticPoints;
+			auto expectedVertex = computeConvexHull3D(pts);
+			for (const auto& theEdge : exploreGraph(expectedVertex)) {
+				expectedPoints.insert(theEdge->origin()->data());
+			}
+
+			convex_hull_options options;
+			options.execution = 3;
+			auto automaticVertex = computeConvexHull3DAutomatic(pts, options);
+			for (const auto& theEdge : exploreGraph(automaticVertex)) {
+				automaticPoints.insert(theEdge->origin()->data());
+			}
+
+			Assert::AreEqual(exploreGraph(expectedVertex).size(), exploreGraph(automaticVertex).size());
+			Assert::IsTrue(expectedPoints == automaticPoints);
+			destroyGraph(expectedVertex);
+			destroyGraph(automaticVertex);
+		}
+	};
+
+	TEST_CLASS(HullStatisticsTests) {
+	public:
+
+		TEST_METHOD(HullStatisticsSphere) {
+			const int numPoints = 1000;
+			std::mt19937_64 randomEngine;
+			std::normal_distribution<double> coordinateGen;
+			std::vector<point<double>> pts(numPoints);
+
+			for (auto& thePoint : pts) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+				double length = std::sqrt(scalarProduct(thePoint, thePoint));
+				thePoint = { thePoint.x / length, thePoint.y / length, thePoint.z / length };
+			}
+
+			convex_hull_statistics statistics;
+			size_t lastJoinFacesCalls = 0;
+			bool countsGrow = true;
+			auto hullVertex = computeConvexHull3D(pts, convex_hull_options(), statistics,
+				[&](convex_hull_update update, const std::shared_ptr<vertex<point<double>>>&, const convex_hull_statistics& current) {
+					if (update == convex_hull_update::afterJoinFaces) {
+						countsGrow &= current.joinFacesCalls == lastJoinFacesCalls + 1;
+						lastJoinFacesCalls = current.joinFacesCalls;
+					}
+				});
+
+			// Every point is a vertex, and each triangle on a horizon edge is a new face
+			Assert::IsTrue(countsGrow);
+			Assert::AreEqual(size_t(numPoints - 4), statistics.joinFacesCalls);
+			Assert::AreEqual(statistics.horizonLength + 4, statistics.facesCreated);
+			Assert::AreEqual(size_t(0), statistics.facesMerged);
+			Assert::AreEqual(size_t(0), statistics.redundantVerticesRemoved);
+			Assert::IsTrue(statistics.orientationTests >= statistics.conflictInserts);
+			Assert::IsTrue(statistics.conflictErases <= statistics.conflictInserts);
+			Assert::IsTrue(statistics.peakConflictListSize > 0 && statistics.peakConflictListSize < numPoints);
+			Assert::AreEqual(6 * numPoints - 12, (int)exploreGraph(hullVertex).size());
+		}
+
+		TEST_METHOD(HullStatisticsCubeLatticeMerges) {
+			std::vector<point<int>> pts;
+			for (int i = 0; i < 6; i++) {
+				for (int j = 0; j < 6; j++) {
+					for (int k = 0; k < 6; k++) {
+						pts.push_back({ i, j, k });
+					}
+				}
+			}
+
+			convex_hull_statistics statistics;
+			computeConvexHull3D(pts, convex_hull_options(), statistics);
+			Assert::IsTrue(statistics.facesMerged > 0);
+			Assert::IsTrue(statistics.redundantVerticesRemoved > 0);
+		}
+
+		TEST_METHOD(HullStatisticsOnlyWithOption) {
+			std::vector<point<int>> pts = { {0, 0, 0}, {4, 0, 0}, {0, 4, 0}, {0, 0, 4}, {1, 1, 1}, {5, 5, 5} };
+
+			incremental_convex_hull<point<int>> plainHull;
+			plainHull.insert(pts);
+			Assert::AreEqual(size_t(0), plainHull.statistics().joinFacesCalls);
+			Assert::AreEqual(size_t(0), plainHull.statistics().orientationTests);
+
+			convex_hull_options options;
+			options.collectStatistics = true;
+			incremental_convex_hull<point<int>> countingHull(options);
+			countingHull.insert(pts);
+			Assert::AreEqual(size_t(1), countingHull.statistics().joinFacesCalls);
+			Assert::IsTrue(countingHull.statistics().orientationTests > 0);
+		}
+	};
+
+	TEST_CLASS(ExtremeSimplexTests) {
+	public:
+
+		TEST_METHOD(ExtremeSimplexCubeLattice) {
+			std::vector<point<int>> pts;
+			for (int i = 0; i < 6; i++) {
+				for (int j = 0; j < 6; j++) {
+					for (int k = 0; k < 6; k++) {
+						pts.push_back({ i, j, k });
+					}
+				}
+			}
+
+			auto simplex = findExtremeSimplex(pts, 4);
+			Assert::AreEqual(4, (int)simplex.size());
+			Assert::IsTrue(pts[simplex[0]] == point<int>{ 0, 0, 0 });
+			Assert::IsTrue(pts[simplex[1]] == point<int>{ 5, 5, 5 });
+			Assert::AreNotEqual(0, orientation(pts[simplex[0]], pts[simplex[1]], pts[simplex[2]], pts[simplex[3]]));
+
+			convex_hull_options options;
+			options.extremeInitialSimplex = true;
+			Assert::AreEqual(24, (int)exploreGraph(computeConvexHull3D(pts, options)).size());
+		}
+
+		TEST_METHOD(ExtremeSimplexDegenerate) {
+			std::vector<point<int>> pts = { {1, 1, 1}, {1, 1, 1} };
+			Assert::AreEqual(1, (int)findExtremeSimplex(pts).size());
+
+			pts = { {0, 0, 0}, {1, 2, 3}, {2, 4, 6}, {3, 6, 9} };
+			Assert::AreEqual(2, (int)findExtremeSimplex(pts).size());
+
+			pts = { {0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0} };
+			Assert::AreEqual(3, (int)findExtremeSimplex(pts).size());
+
+			convex_hull_options options;
+			options.extremeInitialSimplex = true;
+			Assert::AreEqual(4, (int)faceToEdgeList(computeConvexHull3D(pts, options)->incidentEdge()->incidentFace()).size());
+		}
+
+		TEST_METHOD(ExtremeSimplexSortedParaboloid) {
+			// Sorted input makes the first four points a sliver, which almost every point is outside of
+			std::vector<point<long long>> pts;
+			for (long long i = 0; i < 40; i++) {
+				for (long long j = 0; j < 40; j++) {
+					pts.push_back({ i, j, i * i + j * j });
+				}
+			}
+
+			Assert::IsTrue(findExtremeSimplex(pts, 1) == findExtremeSimplex(pts, 8));
+
+			convex_hull_options options;
+			options.extremeInitialSimplex = true;
+			options.execution = parallelExecution(4);
+			convex_hull_statistics plainStatistics, extremeStatistics;
+			auto plainVertex = computeConvexHull3D(pts, convex_hull_options(), plainStatistics);
+			auto extremeVertex = computeConvexHull3D(pts, options, extremeStatistics);
+
+			Assert::AreEqual(exploreGraph(plainVertex).size(), exploreGraph(extremeVertex).size());
+			// The total work depends on the random order of the points, the initial conflict lists don't
+			Assert::IsTrue(extremeStatistics.peakConflictListSize < plainStatistics.peakConflictListSize);
+		}
+	};
+
+	TEST_CLASS(PointSourceTests) {
+	public:
+
+		TEST_METHOD(PointSourcesMatchVectorCubeLattice) {
+			// Interleaved with an unused fourth value, and as separate columns
+			std::vector<point<int>> pts;
+			std::vector<int> interleaved, xs, ys, zs;
+			for (int i = 0; i < 6; i++) {
+				for (int j = 0; j < 6; j++) {
+					for (int k = 0; k < 6; k++) {
+						pts.push_back({ i, j, k });
+						interleaved.insert(interleaved.end(), { i, j, k, -1 });
+						xs.push_back(i);
+						ys.push_back(j);
+						zs.push_back(k);
+					}
+				}
+			}
+
+			span_point_source<point<int>> span = { pts.data(), pts.size() };
+			strided_point_source<int> strided = { interleaved.data(), pts.size(), 4 };
+			soa_point_source<int> columns = { xs.data(), ys.data(), zs.data(), pts.size() };
+
+			Assert::IsTrue(strided[100] == pts[100]);
+			Assert::IsTrue(columns[100] == pts[100]);
+			Assert::AreEqual(24, (int)exploreGraph(computeConvexHull3D(span)).size());
+			Assert::AreEqual(24, (int)exploreGraph(computeConvexHull3D(strided)).size());
+			Assert::AreEqual(24, (int)exploreGraph(computeConvexHull3D(columns)).size());
+
+			convex_hull_options options;
+			options.extremeInitialSimplex = true;
+			Assert::AreEqual(24, (int)exploreGraph(computeConvexHull3D(columns, options)).size());
+		}
+
+		TEST_METHOD(PointSourceIncrementalDegenerate) {
+			// Coplanar points first, so the second insertion starts from the retained planar hull
+			std::vector<int> xs = { 0, 10, 0, 10, 5 }, ys = { 0, 0, 10, 10, 5 };
+			incremental_convex_hull<point<int>> hull;
+			hull.insert(soa_point_source<int>{ xs.data(), ys.data(), nullptr, xs.size() });
+			Assert::IsFalse(hull.isFullDimensional());
+			Assert::AreEqual(4, (int)faceToEdgeList(hull.vertex()->incidentEdge()->incidentFace()).size());
+
+			std::vector<int> apex = { 5, 5, 10 };
+			hull.insert(strided_point_source<int>{ apex.data(), 1, 3 });
+			Assert::IsTrue(hull.isFullDimensional());
+			Assert::AreEqual(16, (int)exploreGraph(hull.vertex()).size());
+		}
+
+		TEST_METHOD(PointSourceDelaunayPlanarBuffer) {
+			std::vector<point<double>> pts;
+			std::vector<double> interleaved;
+			std::mt19937_64 randomEngine;
+			std::uniform_real_distribution<double> coordinateGen(-1, 1);
+			for (int i = 0; i < 200; i++) {
+				double x = coordinateGen(randomEngine), y = coordinateGen(randomEngine);
+				pts.push_back({ x, y, 0 });
+				interleaved.insert(interleaved.end(), { x, y });
+			}
+
+			strided_point_source<double> planar = { interleaved.data(), pts.size(), 2, 2 };
+			auto fromVector = delaunayTriangulation(pts);
+			auto fromBuffer = delaunayTriangulation(planar);
+			Assert::AreEqual(exploreGraph(fromVector->outerComponent()->origin()).size(), exploreGraph(fromBuffer->outerComponent()->origin()).size());
+			Assert::AreEqual(computeVoronoiDiagram(pts).edgeList.size(), computeVoronoiDiagram(planar).edgeList.size());
+		}
+	};
+
+	TEST_CLASS(IndexedHullTests) {
+	public:
+
+		TEST_METHOD(IndexedHullLabelsAreInputIndices) {
+			std::vector<labeled_point<int, std::string>> pts;
+			for (int i = 0; i < 6; i++) {
+				for (int j = 0; j < 6; j++) {
+					for (int k = 0; k < 6; k++) {
+						pts.push_back({ i, j, k, std::string(100, char('a' + i + j + k)) });
+					}
+				}
+			}
+
+			auto hullVertex = computeConvexHull3DIndexed(pts);
+			auto allEdges = exploreGraph(hullVertex);
+			Assert::AreEqual(24, (int)allEdges.size());
+			for (const auto& theEdge : allEdges) {
+				const auto& thePoint = theEdge->origin()->data();
+				const auto& inputPoint = pts[thePoint.label];
+				Assert::IsTrue(thePoint.x == inputPoint.x && thePoint.y == inputPoint.y && thePoint.z == inputPoint.z);
+			}
+		}
+
+		TEST_METHOD(HullIndicesCube) {
+			std::vector<point<int>> pts = { {5, 5, 5} };
+			for (int i = 0; i < 8; i++) {
+				pts.push_back({ 10 * (i & 1), 10 * (i >> 1 & 1), 10 * (i >> 2) });
+			}
+
+			convex_hull_indices hull = computeConvexHull3DIndices(pts);
+			Assert::IsTrue(hull.vertices == std::vector<size_t>{ 1, 2, 3, 4, 5, 6, 7, 8 });
+			Assert::AreEqual(6, (int)hull.faces.size());
+			for (const auto& faceIndices : hull.faces) {
+				Assert::AreEqual(4, (int)faceIndices.size());
+
+				// Every other vertex is on the inner side of the face
+				for (size_t index : hull.vertices) {
+					Assert::IsTrue(orientation(pts[faceIndices[0]], pts[faceIndices[1]], pts[faceIndices[2]], pts[index]) <= 0);
+				}
+			}
+		}
+
+		TEST_METHOD(HullIndicesDegenerate) {
+			std::vector<point<int>> pts = { {0, 0, 0}, {1, 1, 1}, {2, 2, 2} };
+			Assert::AreEqual(0, (int)computeConvexHull3DIndices(pts).vertices.size());
+
+			pts = { {0, 0, 0}, {4, 0, 0}, {0, 4, 0}, {1, 1, 0} };
+			convex_hull_indices hull = computeConvexHull3DIndices(pts);
+			Assert::IsTrue(hull.vertices == std::vector<size_t>{ 0, 1, 2 });
+			Assert::AreEqual(2, (int)hull.faces.size());
+		}
+	};
+
+	TEST_CLASS(HullWorkspaceTests) {
+	public:
+
+		TEST_METHOD(WorkspaceReusedForManySmallHulls) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<int> coordinateGen(-100, 100);
+			std::uniform_int_distribution<size_t> sizeGen(20, 200);
+			hull_workspace<point<int>> workspace;
+
+			for (int repetition = 0; repetition < 20; repetition++) {
+				std::vector<point<int>> pts(sizeGen(randomEngine));
+				for (auto& thePoint : pts) {
+					thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+				}
+
+				convex_hull_options options;
+				options.triangulate = repetition % 2 == 1;
+				auto hullVertex = computeConvexHull3D(workspace, pts, options);
+				auto expectedVertex = computeConvexHull3D(pts, options);
+
+				// Whether points in the middle of an edge are kept as vertices of a triangulation
+				// depends on the order of insertion, so only the default mode gives the same graph
+				if (options.triangulate) {
+					for (const auto& theEdge : exploreGraph(hullVertex)) {
+						Assert::AreEqual(3, (int)faceToEdgeList(theEdge->incidentFace()).size());
+					}
+				}
+				else {
+					Assert::AreEqual(exploreGraph(expectedVertex).size(), exploreGraph(hullVertex).size());
+				}
+
+				destroyGraph(hullVertex);
+				destroyGraph(expectedVertex);
+			}
+		}
+
+		TEST_METHOD(WorkspaceSharedByIncrementalHulls) {
+			hull_workspace<point<int>> workspace;
+			incremental_convex_hull<point<int>> hull(convex_hull_options(), workspace);
+			for (int i = 0; i < 6; i++) {
+				for (int j = 0; j < 6; j++) {
+					std::vector<point<int>> layer;
+					for (int k = 0; k < 6; k++) {
+						layer.push_back({ i, j, k });
+					}
+					hull.insert(layer);
+				}
+			}
+
+			Assert::AreEqual(24, (int)exploreGraph(hull.vertex()).size());
+		}
+
+		TEST_METHOD(HullOutlivesWorkspace) {
+			std::vector<point<int>> pts = { {0, 0, 0}, {10, 0, 0}, {0, 10, 0}, {0, 0, 10}, {10, 10, 10}, {1, 1, 1} };
+			std::shared_ptr<vertex<point<int>>> hullVertex;
+			{
+				hull_workspace<point<int>> workspace;
+				hullVertex = computeConvexHull3D(workspace, pts);
+			}
+
+			// The objects of the graph keep the pool they came from alive
+			Assert::AreEqual(18, (int)exploreGraph(hullVertex).size());
+			destroyGraph(hullVertex);
+		}
+
+		TEST_METHOD(ObjectPoolTakesBackBlocksFromOtherThreads) {
+			auto pool = std::make_shared<object_pool>();
+			pool_scope scope(pool);
+
+			// Freed on another thread, and handed out again on this one
+			void* block = pool->allocate(40);
+			std::thread([&]() { pool->deallocate(block, 40); }).join();
+			Assert::IsTrue(pool->allocate(40) == block);
+
+			// Another thread gets memory from the heap, which the pool keeps once it's freed
+			void* otherBlock = nullptr;
+			std::thread([&]() { otherBlock = pool->allocate(40); }).join();
+			pool->deallocate(otherBlock, 40);
+			Assert::IsTrue(pool->allocate(40) == otherBlock);
+
+			pool->deallocate(block, 40);
+			pool->deallocate(otherBlock, 40);
+		}
+
+		TEST_METHOD(DestroyGraphFreesObjects) {
+			std::vector<point<int>> pts = { {0, 0, 0}, {10, 0, 0}, {0, 10, 0}, {0, 0, 10}, {1, 1, 1} };
+			auto hullVertex = computeConvexHull3D(pts);
+			std::weak_ptr<edge<point<int>>> someEdge = hullVertex->incidentEdge();
+			std::weak_ptr<face<point<int>>> someFace = hullVertex->incidentEdge()->incidentFace();
+
+			destroyGraph(hullVertex);
+			Assert::IsTrue(!hullVertex->incidentEdge());
+			Assert::IsTrue(someEdge.expired());
+			Assert::IsTrue(someFace.expired());
+		}
+	};
+
+	TEST_CLASS(SmallHullTests) {
+	public:
+
+		// Rotates each face to start from its smallest index, so that faces can be compared as sets
+		static std::set<std::vector<size_t>> normalizedFaces(const convex_hull_indices& hull) {
+			std::set<std::vector<size_t>> faces;
+			for (std::vector<size_t> faceIndices : hull.faces) {
+				std::rotate(faceIndices.begin(), std::min_element(faceIndices.begin(), faceIndices.end()), faceIndices.end());
+				faces.insert(faceIndices);
+			}
+			return faces;
+		}
+
+		TEST_METHOD(SmallHullMatchesGeneralHullOnLattices) {
+			// Few distinct coordinates give many coplanar and collinear points
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<int> coordinateGen(0, 3);
+			std::uniform_int_distribution<size_t> sizeGen(1, 64);
+
+			for (int repetition = 0; repetition < 300; repetition++) {
+				std::vector<point<int>> pts(sizeGen(randomEngine));
+				bool isFlat = repetition % 3 == 0;
+				for (auto& thePoint : pts) {
+					thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), isFlat ? 0 : coordinateGen(randomEngine) };
+				}
+
+				convex_hull_indices expected = computeConvexHull3DIndices(pts);
+				convex_hull_indices actual = computeSmallConvexHull3D<64>(pts);
+				Assert::AreEqual(expected.faces.size(), actual.faces.size());
+
+				// Duplicates may be represented by different indices
+				std::set<point<int>> expectedVertices, actualVertices;
+				for (size_t index : expected.vertices) {
+					expectedVertices.insert(pts[index]);
+				}
+				for (size_t index : actual.vertices) {
+					actualVertices.insert(pts[index]);
+				}
+				Assert::IsTrue(expectedVertices == actualVertices);
+
+				for (const auto& faceIndices : actual.faces) {
+					for (size_t index : actual.vertices) {
+						Assert::IsTrue(orientation(pts[faceIndices[0]], pts[faceIndices[1]], pts[faceIndices[2]], pts[index]) <= 0);
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(SmallHullCube) {
+			std::vector<point<int>> pts = { {5, 5, 5} };
+			for (int i = 0; i < 8; i++) {
+				pts.push_back({ 10 * (i & 1), 10 * (i >> 1 & 1), 10 * (i >> 2) });
+			}
+
+			convex_hull_indices expected = computeConvexHull3DIndices(pts);
+			convex_hull_indices actual = computeSmallConvexHull3D<16>(pts);
+			Assert::IsTrue(expected.vertices == actual.vertices);
+			Assert::IsTrue(normalizedFaces(expected) == normalizedFaces(actual));
+		}
+
+		TEST_METHOD(SmallHullFallsBackForLargeInput) {
+			std::vector<point<int>> pts;
+			for (int i = 0; i < 6; i++) {
+				for (int j = 0; j < 6; j++) {
+					for (int k = 0; k < 6; k++) {
+						pts.push_back({ i, j, k });
+					}
+				}
+			}
+
+			convex_hull_indices hull = computeSmallConvexHull3D<64>(pts);
+			Assert::AreEqual(8, (int)hull.vertices.size());
+			Assert::AreEqual(6, (int)hull.faces.size());
+		}
+	};
+
+	TEST_CLASS(BatchHullTests) {
+	public:
+
+		TEST_METHOD(BatchMatchesSingleHulls) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<long long> coordinateGen(-1000, 1000);
+			std::uniform_int_distribution<size_t> sizeGen(0, 120);
+
+			std::vector<point<long long>> pts;
+			std::vector<size_t> offsets = { 0 };
+			std::vector<std::vector<point<long long>>> pointSets;
+			for (int i = 0; i < 80; i++) {
+				std::vector<point<long long>> pointSet(i % 20 == 0 ? 3 : sizeGen(randomEngine));
+				for (auto& thePoint : pointSet) {
+					thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+				}
+
+				pts.insert(pts.end(), pointSet.begin(), pointSet.end());
+				offsets.push_back(pts.size());
+				pointSets.push_back(pointSet);
+			}
+
+			convex_hull_options options;
+			options.execution = parallelExecution(4);
+			convex_hull_batch fromBuffer = computeConvexHull3DBatch(pts, offsets, options);
+			convex_hull_batch fromSets = computeConvexHull3DBatch(pointSets, options);
+			Assert::AreEqual(pointSets.size(), fromBuffer.size());
+			Assert::IsTrue(fromBuffer.faceOffsets == fromSets.faceOffsets);
+
+			for (size_t i = 0; i < pointSets.size(); i++) {
+				convex_hull_indices expected = computeConvexHull3DIndices(pointSets[i]);
+				Assert::AreEqual(expected.faces.size(), fromBuffer.faceOffsets[i + 1] - fromBuffer.faceOffsets[i]);
+
+				std::set<size_t> batchVertices;
+				for (size_t f = fromBuffer.faceOffsets[i]; f < fromBuffer.faceOffsets[i + 1]; f++) {
+					batchVertices.insert(fromBuffer.faceVertices.begin() + fromBuffer.vertexOffsets[f], fromBuffer.faceVertices.begin() + fromBuffer.vertexOffsets[f + 1]);
+				}
+				Assert::IsTrue(batchVertices == std::set<size_t>(expected.vertices.begin(), expected.vertices.end()));
+			}
+		}
+
+		TEST_METHOD(BatchEmpty) {
+			convex_hull_batch batch = computeConvexHull3DBatch(std::vector<std::vector<point<int>>>());
+			Assert::AreEqual(size_t(0), batch.size());
+			Assert::AreEqual(size_t(1), batch.vertexOffsets.size());
+		}
+	};
+
+	TEST_CLASS(CancellationTests) {
+	public:
+
+		static std::vector<point<long long>> randomPoints(size_t count) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<long long> coordinateGen(-1000, 1000);
+			std::vector<point<long long>> pts(count);
+			for (auto& thePoint : pts) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+			}
+			return pts;
+		}
+
+		// Checks that the graph is a convex polyhedron: every vertex is on the inner side of every face
+		static void assertConvex(const std::shared_ptr<vertex<point<long long>>>& hullVertex) {
+			std::vector<point<long long>> hullPoints;
+			for (const auto& theEdge : exploreGraph(hullVertex)) {
+				hullPoints.push_back(theEdge->origin()->data());
+			}
+
+			for (const auto& theEdge : exploreGraph(hullVertex)) {
+				for (const auto& thePoint : hullPoints) {
+					Assert::IsTrue(facePointOrientation(theEdge->incidentFace(), thePoint) <= 0);
+				}
+			}
+		}
+
+		TEST_METHOD(CancelledMidway) {
+			std::vector<point<long long>> pts = randomPoints(5000);
+			std::atomic<bool> cancelled{ false };
+			convex_hull_options options;
+			options.cancellationToken = &cancelled;
+
+			int pointsAdded = 0;
+			incremental_convex_hull<point<long long>> hull(options);
+			hull.insert(pts, [&](convex_hull_update update, const std::shared_ptr<vertex<point<long long>>>&) {
+				if (update == convex_hull_update::afterRemoveRedundantVertices && ++pointsAdded == 50) {
+					cancelled = true;
+				}
+			});
+
+			Assert::IsTrue(hull.isPartial());
+			Assert::AreEqual(50, pointsAdded);
+			assertConvex(hull.vertex());
+
+			bool isPartial = true;
+			cancelled = false;
+			auto fullVertex = computeConvexHull3D(pts, options, isPartial);
+			Assert::IsFalse(isPartial);
+			Assert::IsTrue(exploreGraph(fullVertex).size() > exploreGraph(hull.vertex()).size());
+		}
+
+		TEST_METHOD(DeadlinePassed) {
+			std::vector<point<long long>> pts = randomPoints(1000);
+			convex_hull_options options;
+			options.deadline = std::chrono::steady_clock::now();
+
+			bool isPartial = false;
+			auto hullVertex = computeConvexHull3D(pts, options, isPartial);
+			Assert::IsTrue(isPartial);
+
+			// Only the initial tetrahedron has been built
+			Assert::AreEqual(12, (int)exploreGraph(hullVertex).size());
+			assertConvex(hullVertex);
+		}
+
+		TEST_METHOD(CancelledDuringConflictInitialization) {
+			// Enough points for several blocks, none of which gets past its first point
+			std::vector<point<long long>> pts = randomPoints(40000);
+			std::atomic<bool> cancelled{ true };
+			convex_hull_options options;
+			options.cancellationToken = &cancelled;
+			options.execution = parallelExecution();
+
+			incremental_convex_hull<point<long long>> hull(options);
+			hull.insert(pts);
+			Assert::IsTrue(hull.isPartial());
+			Assert::AreEqual(12, (int)exploreGraph(hull.vertex()).size());
+			Assert::AreEqual(0, (int)hull.statistics().conflictInserts);
+			Assert::AreEqual(0, (int)hull.statistics().joinFacesCalls);
+			assertConvex(hull.vertex());
+		}
+	};
+
+	TEST_CLASS(DeduplicationTests) {
+	public:
+
+		TEST_METHOD(DeduplicateMatchesMap) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<int> coordinateGen(0, 20);
+			std::vector<point<int>> pts(100000);
+			for (auto& thePoint : pts) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+			}
+
+			std::map<point<int>, size_t> firstIndex;
+			for (size_t i = 0; i < pts.size(); i++) {
+				firstIndex.insert({ pts[i], i });
+			}
+
+			deduplicated_points distinctPoints = deduplicatePoints(pts, 4);
+			Assert::AreEqual(firstIndex.size(), distinctPoints.representatives.size());
+			Assert::IsTrue(std::is_sorted(distinctPoints.representatives.begin(), distinctPoints.representatives.end()));
+			for (size_t i = 0; i < pts.size(); i++) {
+				Assert::AreEqual(firstIndex[pts[i]], distinctPoints.representativeOf[i]);
+			}
+		}
+
+		TEST_METHOD(HullWithRemoveDuplicates) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<long long> coordinateGen(-1000, 1000);
+			std::vector<point<long long>> distinct(300);
+			for (auto& thePoint : distinct) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+			}
+
+			std::vector<point<long long>> pts;
+			for (int copy = 0; copy < 5; copy++) {
+				pts.insert(pts.end(), distinct.begin(), distinct.end());
+			}
+			std::shuffle(pts.begin(), pts.end(), randomEngine);
+
+			convex_hull_options options;
+			options.removeDuplicates = true;
+			convex_hull_indices hull = computeConvexHull3DIndices(pts, options);
+			convex_hull_indices expected = computeConvexHull3DIndices(distinct);
+			Assert::AreEqual(expected.vertices.size(), hull.vertices.size());
+			Assert::AreEqual(expected.faces.size(), hull.faces.size());
+
+			deduplicated_points distinctPoints = deduplicatePoints(pts);
+			for (size_t index : hull.vertices) {
+				Assert::AreEqual(index, distinctPoints.representativeOf[index]);
+			}
+		}
+
+		TEST_METHOD(DelaunayWithRemoveDuplicates) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<long long> coordinateGen(0, 30);
+			std::vector<point<long long>> pts(2000);
+			for (auto& thePoint : pts) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), 0 };
+			}
+
+			convex_hull_options options;
+			options.removeDuplicates = true;
+			auto outerFace = delaunayTriangulation(pts, options);
+			auto expectedFace = delaunayTriangulation(pts);
+
+			auto allEdges = exploreGraph(outerFace->outerComponent()->origin());
+			Assert::AreEqual(exploreGraph(expectedFace->outerComponent()->origin()).size(), allEdges.size());
+
+			deduplicated_points distinctPoints = deduplicatePoints(pts);
+			for (const auto& theEdge : allEdges) {
+				size_t index = theEdge->origin()->data().label;
+				Assert::AreEqual(index, distinctPoints.representativeOf[index]);
+			}
+		}
+	};
+
+	TEST_CLASS(ConvexHull2DTests) {
+	public:
+
+		TEST_METHOD(SquareWithSidePoints) {
+			std::vector<point<int>> pts = { {1, 1, 0}, {0, 0, 0}, {2, 0, 0}, {1, 0, 0}, {2, 2, 0}, {0, 2, 0}, {0, 1, 0}, {2, 2, 0} };
+
+			std::vector<size_t> expected = { 1, 2, 4, 5 };
+			Assert::IsTrue(expected == convexHull2DIndices(pts));
+
+			convex_hull_2d_options options;
+			options.keepCollinear = true;
+			std::vector<size_t> expectedWithSides = { 1, 3, 2, 4, 5, 6 };
+			Assert::IsTrue(expectedWithSides == convexHull2DIndices(pts, options));
+
+			auto polygon = convexHull2DPolygon(pts);
+			Assert::AreEqual(4, (int)faceToEdgeList(polygon).size());
+		}
+
+		TEST_METHOD(Collinear) {
+			std::vector<point<int>> pts = { {1, 1, 0}, {3, 3, 0}, {0, 0, 0}, {2, 2, 0}, {0, 0, 0} };
+			convex_hull_2d_options options;
+			for (bool keepCollinear : { false, true }) {
+				options.keepCollinear = keepCollinear;
+				std::vector<size_t> expected = { 2, 1 };
+				Assert::IsTrue(expected == convexHull2DIndices(pts, options));
+			}
+			Assert::IsFalse(!!convexHull2DPolygon(pts));
+		}
+
+		TEST_METHOD(RandomPointsAreInsideStrictlyConvexHull) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<long long> coordinateGen(-1000, 1000);
+			convex_hull_2d_options options;
+			options.execution = parallelExecution(4);
+
+			for (size_t n : { 5, 100, 200000 }) {
+				std::vector<point<long long>> pts(n);
+				for (auto& thePoint : pts) {
+					thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), 0 };
+				}
+
+				std::vector<size_t> hullIndices = convexHull2DIndices(pts, options);
+				size_t m = hullIndices.size();
+				for (size_t i = 0; i < m; i++) {
+					const auto& a = pts[hullIndices[i]];
+					const auto& b = pts[hullIndices[(i + 1) % m]];
+					Assert::IsTrue(orientation2D(a, b, pts[hullIndices[(i + 2) % m]]) > 0);
+					for (const auto& thePoint : pts) {
+						Assert::IsTrue(orientation2D(a, b, thePoint) >= 0);
+					}
+				}
+			}
+		}
+	};
+
+	TEST_CLASS(ExecutionPolicyTests) {
+	public:
+
+		// An executor which runs the tasks on the calling thread, in reverse, and records how many it got
+		struct recording_executor {
+			std::vector<size_t>& taskCounts;
+
+			void operator()(size_t taskCount, const std::function<void(size_t)>& task) const {
+				taskCounts.push_back(taskCount);
+				for (size_t i = taskCount; i-- > 0;) {
+					task(i);
+				}
+			}
+		};
+
+		TEST_METHOD(PoolExecutorRunsHullStages) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<long long> coordinateGen(-1000, 1000);
+			std::vector<point<long long>> pts(40000);
+			for (auto& thePoint : pts) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+			}
+
+			std::vector<size_t> taskCounts;
+			convex_hull_options options;
+			options.extremeInitialSimplex = true;
+			options.removeDuplicates = true;
+			auto pooledVertex = computeConvexHull3D(poolExecution(recording_executor{ taskCounts }, 4), pts, options);
+			auto sequentialVertex = computeConvexHull3D(sequentialExecution(), pts, options);
+
+			// The extreme simplex, the sort of the duplicate pass and the conflict graph all went through the pool
+			Assert::IsTrue(taskCounts.size() >= 3);
+			for (size_t taskCount : taskCounts) {
+				Assert::IsTrue(taskCount > 1 && taskCount <= 4);
+			}
+
+			std::set<point<long long>> pooledVertices, sequentialVertices;
+			for (const auto& theEdge : exploreGraph(pooledVertex)) {
+				pooledVertices.insert(theEdge->origin()->data());
+			}
+			for (const auto& theEdge : exploreGraph(sequentialVertex)) {
+				sequentialVertices.insert(theEdge->origin()->data());
+			}
+			Assert::IsTrue(pooledVertices == sequentialVertices);
+		}
+
+		TEST_METHOD(VoronoiWithPolicy) {
+			std::mt19937_64 randomEngine;
+			std::uniform_real_distribution<double> coordinateGen(-1, 1);
+			std::vector<point<double>> pts(5000);
+			for (auto& thePoint : pts) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), 0 };
+			}
+
+			auto outerFace = delaunayTriangulation(pts);
+			std::vector<size_t> taskCounts;
+			auto sequential = computeVoronoiDiagram(outerFace, sequentialExecution());
+			auto pooled = computeVoronoiDiagram(outerFace, poolExecution(recording_executor{ taskCounts }, 3));
+
+			// The circumcenters and the edges
+			Assert::AreEqual(size_t(2), taskCounts.size());
+			Assert::AreEqual(sequential.pointList.size(), pooled.pointList.size());
+			for (size_t i = 0; i < sequential.pointList.size(); i++) {
+				Assert::AreEqual(sequential.pointList[i].x, pooled.pointList[i].x);
+				Assert::AreEqual(sequential.pointList[i].y, pooled.pointList[i].y);
+			}
+			Assert::AreEqual(sequential.edgeList.size(), pooled.edgeList.size());
+			for (size_t i = 0; i < sequential.edgeList.size(); i++) {
+				Assert::AreEqual(sequential.edgeList[i].u, pooled.edgeList[i].u);
+				Assert::AreEqual(sequential.edgeList[i].v, pooled.edgeList[i].v);
+			}
+
+			auto fromPoints = computeVoronoiDiagram(parallelExecution(2), pts);
+			Assert::AreEqual(sequential.edgeList.size(), fromPoints.edgeList.size());
+		}
+
+		// Rotates each cycle of indices to start from its smallest one, so that graphs built in
+		// different orders can be compared
+		static std::set<std::vector<size_t>> normalizedCycles(std::vector<std::vector<size_t>> cycles) {
+			for (std::vector<size_t>& cycle : cycles) {
+				std::rotate(cycle.begin(), std::min_element(cycle.begin(), cycle.end()), cycle.end());
+			}
+			return std::set<std::vector<size_t>>(cycles.begin(), cycles.end());
+		}
+
+		TEST_METHOD(IndexExportsWithPolicy) {
+			// All the points of a paraboloid are hull vertices, which gives a graph big enough for several blocks
+			std::vector<point<long long>> pts;
+			for (long long i = 0; i < 60; i++) {
+				for (long long j = 0; j < 60; j++) {
+					pts.push_back({ i, j, i * i + j * j });
+				}
+			}
+
+			std::vector<size_t> taskCounts;
+			auto sequentialHull = extractHullIndices(computeConvexHull3DIndexed(pts), sequentialExecution());
+			auto pooledHull = extractHullIndices(computeConvexHull3DIndexed(pts), poolExecution(recording_executor{ taskCounts }, 3));
+			Assert::AreEqual(size_t(1), taskCounts.size());
+			Assert::IsTrue(sequentialHull.vertices == pooledHull.vertices);
+			Assert::AreEqual(sequentialHull.faces.size(), pooledHull.faces.size());
+			Assert::IsTrue(normalizedCycles(sequentialHull.faces) == normalizedCycles(pooledHull.faces));
+
+			for (auto& thePoint : pts) {
+				thePoint.z = 0;
+			}
+			taskCounts.clear();
+			auto sequentialCells = extractDelaunayIndices(delaunayTriangulation(pts), sequentialExecution());
+			auto pooledCells = extractDelaunayIndices(delaunayTriangulation(pts), poolExecution(recording_executor{ taskCounts }, 3));
+			Assert::AreEqual(size_t(1), taskCounts.size());
+			Assert::AreEqual(sequentialCells.cells.size(), pooledCells.cells.size());
+			Assert::IsTrue(normalizedCycles(sequentialCells.cells) == normalizedCycles(pooledCells.cells));
+			Assert::IsTrue(normalizedCycles({ sequentialCells.boundary }) == normalizedCycles({ pooledCells.boundary }));
+		}
+	};
+
+	TEST_CLASS(WarmStartTests) {
+	public:
+
+		static std::set<point<long long>> hullVertices(const std::shared_ptr<vertex<point<long long>>>& hullVertex) {
+			std::set<point<long long>> vertices;
+			for (const auto& theEdge : exploreGraph(hullVertex)) {
+				vertices.insert(theEdge->origin()->data());
+			}
+			return vertices;
+		}
+
+		TEST_METHOD(WarmStartMatchesScratchOverFrames) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<long long> coordinateGen(-1000, 1000), jitterGen(-5, 5);
+			std::vector<point<long long>> pts(1500);
+			for (auto& thePoint : pts) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+			}
+
+			auto previousHull = computeConvexHull3D(pts);
+			for (int frame = 0; frame < 6; frame++) {
+				// Some points move a little, and the later frames drop a few of the points
+				for (auto& thePoint : pts) {
+					if (randomEngine() % 4 == 0) {
+						thePoint = { thePoint.x + jitterGen(randomEngine), thePoint.y + jitterGen(randomEngine), thePoint.z + jitterGen(randomEngine) };
+					}
+				}
+				if (frame >= 3) {
+					pts.resize(pts.size() - 50);
+				}
+
+				auto warmHull = computeConvexHull3DWarm(previousHull, pts);
+				auto expectedHull = computeConvexHull3D(pts);
+				Assert::IsTrue(hullVertices(expectedHull) == hullVertices(warmHull));
+				Assert::AreEqual(exploreGraph(expectedHull).size(), exploreGraph(warmHull).size());
+				previousHull = warmHull;
+			}
+		}
+
+		TEST_METHOD(WarmStartWithoutUsableSeed) {
+			std::vector<point<long long>> pts;
+			for (long long i = 0; i < 5; i++) {
+				for (long long j = 0; j < 5; j++) {
+					for (long long k = 0; k < 5; k++) {
+						pts.push_back({ i, j, k });
+					}
+				}
+			}
+
+			// No previous hull, a previous hull none of whose vertices are left, and one with only a flat face left
+			std::vector<point<long long>> shifted = pts, flatSeed = pts;
+			for (auto& thePoint : shifted) {
+				thePoint.x += 10;
+			}
+			for (auto& thePoint : flatSeed) {
+				if (thePoint.z == 4) {
+					thePoint.z = 5;
+				}
+			}
+
+			auto expected = hullVertices(computeConvexHull3D(pts));
+			Assert::IsTrue(expected == hullVertices(computeConvexHull3DWarm(std::shared_ptr<vertex<point<long long>>>(), pts)));
+			Assert::IsTrue(expected == hullVertices(computeConvexHull3DWarm(computeConvexHull3D(shifted), pts)));
+			Assert::IsTrue(expected == hullVertices(computeConvexHull3DWarm(computeConvexHull3D(flatSeed), pts)));
+		}
+	};
+
+	TEST_CLASS(SlidingWindowHullTests) {
+	public:
+
+		// The corners of the faces, without the vertices in the middle of a side which flat hulls
+		// keep depending on the order of insertion
+		static std::set<point<long long>> cornerPoints(const convex_hull_indices& hull, const std::vector<point<long long>>& points) {
+			std::set<point<long long>> corners;
+			if (hull.faces.empty()) {
+				for (size_t index : hull.vertices) {
+					corners.insert(points[index]);
+				}
+			}
+
+			for (const std::vector<size_t>& faceIndices : hull.faces) {
+				size_t n = faceIndices.size();
+				for (size_t i = 0; i < n; i++) {
+					const point<long long>& previous = points[faceIndices[(i + n - 1) % n]];
+					const point<long long>& current = points[faceIndices[i]];
+					const point<long long>& next = points[faceIndices[(i + 1) % n]];
+					if (!collinear(previous, current, next)) {
+						corners.insert(current);
+					}
+				}
+			}
+
+			return corners;
+		}
+
+		// Checks the hull of the window against the hull of the same points computed from scratch
+		static void assertMatchesWindow(const sliding_window_hull<point<long long>>& window, const std::vector<point<long long>>& stream) {
+			size_t first = window.frontSequenceNumber();
+			std::vector<point<long long>> windowPoints(stream.begin() + first, stream.begin() + first + window.size());
+			convex_hull_indices expected = computeConvexHull3DIndices(windowPoints);
+			convex_hull_indices actual = window.hullIndices();
+
+			for (size_t sequenceNumber : actual.vertices) {
+				Assert::IsTrue(sequenceNumber >= first && sequenceNumber < first + window.size());
+			}
+
+			Assert::IsTrue(cornerPoints(expected, windowPoints) == cornerPoints(actual, stream));
+			Assert::AreEqual(expected.faces.size(), actual.faces.size());
+		}
+
+		TEST_METHOD(RandomStream) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<long long> coordinateGen(-1000, 1000);
+			std::vector<point<long long>> stream(3000);
+			for (auto& thePoint : stream) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+			}
+
+			sliding_window_hull<point<long long>> window;
+			for (size_t i = 0; i < stream.size(); i++) {
+				Assert::AreEqual(i, window.push(stream[i]));
+				if (window.size() > 200) {
+					window.pop();
+				}
+				if (i % 97 == 0) {
+					assertMatchesWindow(window, stream);
+				}
+			}
+		}
+
+		TEST_METHOD(DegenerateStream) {
+			// A line, then a plane, then points off the plane, with the window sliding over all of it
+			std::vector<point<long long>> stream;
+			for (long long i = 0; i < 30; i++) {
+				stream.push_back({ i, 2 * i, 0 });
+			}
+			for (long long i = 0; i < 30; i++) {
+				stream.push_back({ i % 7, i / 7, 0 });
+			}
+			for (long long i = 0; i < 30; i++) {
+				stream.push_back({ i % 5, i % 3, i % 4 });
+			}
+
+			sliding_window_hull<point<long long>> window;
+			for (size_t i = 0; i < stream.size(); i++) {
+				window.push(stream[i]);
+				if (window.size() > 25) {
+					window.pop();
+				}
+				assertMatchesWindow(window, stream);
+			}
+
+			while (!window.empty()) {
+				window.pop();
+			}
+			Assert::AreEqual(size_t(0), window.hullIndices().faces.size());
+		}
+
+		TEST_METHOD(ConvexCurveStream) {
+			// Every point of the moment curve is a vertex of the hull of any window
+			std::vector<point<long long>> stream;
+			for (long long t = 0; t < 400; t++) {
+				stream.push_back({ t, t * t, t * t * t });
+			}
+
+			sliding_window_hull<point<long long>> window;
+			for (size_t i = 0; i < stream.size(); i++) {
+				window.push(stream[i]);
+				if (window.size() > 60) {
+					window.pop();
+				}
+				if (i % 23 == 22) {
+					assertMatchesWindow(window, stream);
+					Assert::AreEqual(window.size(), window.hullIndices().vertices.size());
+				}
+			}
+		}
+	};
+
+	TEST_CLASS(ConvexLayersTests) {
+	public:
+
+		// Peels the layers one hull at a time, and lists the points of each layer
+		static std::vector<std::multiset<point<long long>>> peelLayers(const std::vector<point<long long>>& points) {
+			std::vector<std::multiset<point<long long>>> result;
+			std::vector<point<long long>> remaining = points;
+			while (!remaining.empty()) {
+				incremental_convex_hull<labeled_point<long long, size_t>> hull;
+				hull.insert(index_labeled_point_source<std::vector<point<long long>>>{ remaining });
+
+				std::vector<bool> isPeeled(remaining.size());
+				result.emplace_back();
+				for (const auto& vertex : hull.vertices()) {
+					isPeeled[vertex.label] = true;
+					result.back().insert(remaining[vertex.label]);
+				}
+				hullgraph::destroyGraph(hull.vertex());
+
+				std::vector<point<long long>> next;
+				for (size_t i = 0; i < remaining.size(); i++) {
+					if (!isPeeled[i]) {
+						next.push_back(remaining[i]);
+					}
+				}
+				remaining.swap(next);
+			}
+
+			return result;
+		}
+
+		static void assertLayersMatch(const std::vector<point<long long>>& points) {
+			std::vector<size_t> layers = computeConvexLayers3D(points);
+			std::vector<std::multiset<point<long long>>> expected = peelLayers(points);
+
+			std::vector<std::multiset<point<long long>>> actual(expected.size());
+			for (size_t i = 0; i < points.size(); i++) {
+				Assert::IsTrue(layers[i] < expected.size());
+				actual[layers[i]].insert(points[i]);
+			}
+
+			Assert::IsTrue(expected == actual);
+		}
+
+		TEST_METHOD(RandomPoints) {
+			// Enough points for the core to be built, shrunk and built again
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<long long> coordinateGen(-10000, 10000);
+			std::vector<point<long long>> points(3500);
+			for (auto& thePoint : points) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+			}
+
+			assertLayersMatch(points);
+		}
+
+		TEST_METHOD(RoundedPoints) {
+			// Points in a ball, with many equal points and points on the same planes
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<long long> coordinateGen(-20, 20);
+			std::vector<point<long long>> points;
+			while (points.size() < 3500) {
+				point<long long> thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+				if (scalarProduct(thePoint, thePoint) <= 400) {
+					points.push_back(thePoint);
+				}
+			}
+
+			assertLayersMatch(points);
+		}
+
+		TEST_METHOD(FlatPoints) {
+			// A grid in a plane, whose last layers are a segment and a single point
+			std::vector<point<long long>> points;
+			for (long long i = 0; i < 9; i++) {
+				for (long long j = 0; j < 5; j++) {
+					points.push_back({ i, j, i + j });
+				}
+			}
+
+			assertLayersMatch(points);
+			Assert::AreEqual(size_t(0), computeConvexLayers3D(std::vector<point<long long>>()).size());
+		}
+	};
+
+	TEST_CLASS(MergeHullsTests) {
+	public:
+
+		static std::set<point<long long>> hullVertices(const std::shared_ptr<vertex<point<long long>>>& hullVertex) {
+			std::set<point<long long>> vertices;
+			for (const auto& theEdge : exploreGraph(hullVertex)) {
+				vertices.insert(theEdge->origin()->data());
+			}
+			return vertices;
+		}
+
+		// Merges the hulls of the shards and checks the result against the hull of all points
+		static void assertMergeMatches(const std::vector<std::vector<point<long long>>>& shards, const convex_hull_options& options) {
+			std::vector<point<long long>> allPoints;
+			std::vector<std::shared_ptr<vertex<point<long long>>>> hulls;
+			for (const auto& shard : shards) {
+				allPoints.insert(allPoints.end(), shard.begin(), shard.end());
+				hulls.push_back(computeConvexHull3D(shard, options));
+			}
+
+			auto mergedHull = mergeHulls(hulls, options);
+			auto expectedHull = computeConvexHull3D(allPoints, options);
+			Assert::IsTrue(hullVertices(expectedHull) == hullVertices(mergedHull));
+			Assert::AreEqual(exploreGraph(expectedHull).size(), exploreGraph(mergedHull).size());
+			destroyGraph(mergedHull);
+			destroyGraph(expectedHull);
+		}
+
+		TEST_METHOD(MergeOverlappingShards) {
+			// Points near a sphere give hulls with many faces, and a grid gives points on their planes
+			std::mt19937_64 randomEngine;
+			std::normal_distribution<double> directionGen(0, 1);
+			std::uniform_int_distribution<long long> radiusGen(9000, 10000);
+			std::vector<std::vector<point<long long>>> shards(7);
+			for (auto& shard : shards) {
+				for (int i = 0; i < 400; i++) {
+					double x = directionGen(randomEngine), y = directionGen(randomEngine), z = directionGen(randomEngine);
+					double scale = double(radiusGen(randomEngine)) / std::sqrt(x * x + y * y + z * z);
+					shard.push_back({ (long long)(x * scale), (long long)(y * scale), (long long)(z * scale) });
+				}
+			}
+
+			shards.emplace_back();
+			for (long long i = -3; i <= 3; i++) {
+				for (long long j = -3; j <= 3; j++) {
+					for (long long k = -3; k <= 3; k++) {
+						shards.back().push_back({ i * 2000, j * 2000, k * 2000 });
+					}
+				}
+			}
+
+			convex_hull_options options;
+			assertMergeMatches(shards, options);
+			options.execution = parallelExecution(4);
+			assertMergeMatches(shards, options);
+		}
+
+		TEST_METHOD(MergeDisjointHulls) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<long long> coordinateGen(-1000, 1000);
+			std::vector<std::vector<point<long long>>> shards(2);
+			for (int i = 0; i < 2000; i++) {
+				shards[0].push_back({ coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) });
+				shards[1].push_back({ coordinateGen(randomEngine) + 5000, coordinateGen(randomEngine), coordinateGen(randomEngine) });
+			}
+
+			assertMergeMatches(shards, convex_hull_options());
+		}
+
+		TEST_METHOD(MergeDegenerateHulls) {
+			// Two flat hulls, one of them on the plane of a face of the other ones, and a cube, each
+			// merged with the others
+			std::vector<point<long long>> square = { { 0, 0, 0 }, { 4, 0, 0 }, { 0, 4, 0 }, { 4, 4, 0 }, { 2, 2, 0 } };
+			std::vector<point<long long>> triangle = { { 1, 1, -3 }, { 1, 1, 3 }, { 9, 1, 0 } };
+			std::vector<point<long long>> faceSquare = { { -1, -1, 5 }, { 7, -1, 5 }, { -1, 7, 5 }, { 7, 7, 5 } };
+			std::vector<point<long long>> cube;
+			for (long long i = -1; i <= 5; i += 6) {
+				for (long long j = -1; j <= 5; j += 6) {
+					for (long long k = -1; k <= 5; k += 6) {
+						cube.push_back({ i, j, k });
+					}
+				}
+			}
+
+			std::vector<std::vector<point<long long>>> hulls = { square, triangle, faceSquare, cube };
+			for (size_t i = 0; i < hulls.size(); i++) {
+				for (size_t j = 0; j < hulls.size(); j++) {
+					assertMergeMatches({ hulls[i], hulls[j] }, convex_hull_options());
+				}
+			}
+
+			Assert::IsTrue(!mergeHulls(std::vector<std::shared_ptr<vertex<point<long long>>>>()));
+			auto cubeHull = mergeHulls(std::shared_ptr<vertex<point<long long>>>(), computeConvexHull3D(cube));
+			Assert::IsTrue(hullVertices(cubeHull) == std::set<point<long long>>(cube.begin(), cube.end()));
+			destroyGraph(cubeHull);
+		}
+
+		TEST_METHOD(MergeCollinearPoints) {
+			// The hull of a segment has no graph, its extremes are merged as points
+			std::vector<point<long long>> segment = { { -2, 1, 1 }, { 3, 1, 1 }, { 8, 1, 1 } };
+			std::vector<point<long long>> square = { { 0, 0, 0 }, { 4, 0, 0 }, { 0, 4, 0 }, { 4, 4, 0 } };
+			incremental_convex_hull<point<long long>> segmentHull;
+			segmentHull.insert(segment);
+			Assert::IsTrue(!segmentHull.vertex());
+
+			std::vector<point<long long>> allPoints = square;
+			allPoints.insert(allPoints.end(), segment.begin(), segment.end());
+			auto expectedHull = computeConvexHull3D(allPoints);
+
+			auto mergedHull = mergeHulls(computeConvexHull3D(square), segmentHull.vertices());
+			Assert::IsTrue(hullVertices(expectedHull) == hullVertices(mergedHull));
+			Assert::AreEqual(exploreGraph(expectedHull).size(), exploreGraph(mergedHull).size());
+			destroyGraph(mergedHull);
+
+			std::vector<std::shared_ptr<vertex<point<long long>>>> hulls = { computeConvexHull3D(square), nullptr };
+			mergedHull = mergeHulls(hulls, segmentHull.vertices());
+			Assert::IsTrue(hullVertices(expectedHull) == hullVertices(mergedHull));
+			destroyGraph(mergedHull);
+			destroyGraph(expectedHull);
+		}
+	};
+
+	TEST_CLASS(ShardedHullTests) {
+	public:
+
+		// A path in the temporary directory which no other test run uses at the same time
+		static std::string uniqueTempPath() {
+			static std::atomic<unsigned> fileCount{ 0 };
+			std::string name = "ConvexHull3DShardedHullTests-" + std::to_string(std::random_device()()) + "-" + std::to_string(fileCount++) + ".bin";
+			return (std::filesystem::temp_directory_path() / name).string();
+		}
+
+		template<class F>
+		static std::string writePointFile(const std::vector<point<F>>& points) {
+			std::string path = uniqueTempPath();
+			std::ofstream output(path, std::ios::binary);
+			output.write(reinterpret_cast<const char*>(points.data()), std::streamsize(points.size() * sizeof(point<F>)));
+			return path;
+		}
+
+		// Runs the workers in this process, sending their hulls through the same bytes as a pipe would
+		static std::unique_ptr<std::istream> launchInProcess(const shard_range& range) {
+			auto output = std::make_unique<std::stringstream>();
+			Assert::IsTrue(writeShardHull<long long>(range, *output, 1000));
+			return output;
+		}
+
+		static void assertShardedMatches(const std::vector<point<long long>>& points, size_t shardCount) {
+			std::string path = writePointFile(points);
+			convex_hull_options options;
+			options.execution = parallelExecution(4);
+			auto shardedHull = computeConvexHull3DSharded<long long>(path, shardCount, launchInProcess, options);
+			auto expectedHull = computeConvexHull3D(points);
+			std::filesystem::remove(path);
+
+			std::set<point<long long>> shardedVertices, expectedVertices;
+			for (const auto& theEdge : exploreGraph(shardedHull)) {
+				shardedVertices.insert(theEdge->origin()->data());
+			}
+			for (const auto& theEdge : exploreGraph(expectedHull)) {
+				expectedVertices.insert(theEdge->origin()->data());
+			}
+
+			Assert::IsTrue(expectedVertices == shardedVertices);
+			Assert::AreEqual(exploreGraph(expectedHull).size(), exploreGraph(shardedHull).size());
+			destroyGraph(shardedHull);
+			destroyGraph(expectedHull);
+		}
+
+		TEST_METHOD(ShardedHullMatchesInMemoryHull) {
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<long long> coordinateGen(-10000, 10000);
+			std::vector<point<long long>> points(5000);
+			for (auto& thePoint : points) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+			}
+
+			assertShardedMatches(points, 5);
+			assertShardedMatches(points, 1);
+		}
+
+		TEST_METHOD(ShardedHullWithDegenerateShards) {
+			// The first shard is collinear and sticks out of the others, the second one is flat,
+			// and with more shards than points every shard is a single point
+			std::vector<point<long long>> points;
+			for (long long i = 0; i < 10; i++) {
+				points.push_back({ i * 10, 0, 0 });
+			}
+			for (long long i = 0; i < 10; i++) {
+				points.push_back({ i % 4, i / 4, 1 });
+			}
+			for (long long i = 0; i < 10; i++) {
+				points.push_back({ i % 3, i % 5, i % 7 });
+			}
+
+			assertShardedMatches(points, 3);
+			assertShardedMatches(std::vector<point<long long>>(points.begin(), points.begin() + 4), 10);
+		}
+
+		TEST_METHOD(FailedShardWorker) {
+			std::vector<point<long long>> points = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+			std::string path = writePointFile(points);
+			std::stringstream output;
+			Assert::IsFalse(writeShardHull<long long>(shard_range{ path, 2, 3 }, output, 1000));
+			Assert::IsTrue(writeShardHull<long long>(shard_range{ path, 0, 4 }, output, 1000));
+			std::filesystem::remove(path);
+
+			// A worker which sends nothing, and one which stops in the middle of its hull
+			std::stringstream emptyOutput, truncatedOutput(output.str().substr(0, output.str().size() - 1));
+			Assert::ExpectException<std::runtime_error>([&]() { readShardVertices<long long>(emptyOutput); });
+			Assert::ExpectException<std::runtime_error>([&]() { readShardVertices<long long>(truncatedOutput); });
+			Assert::AreEqual(size_t(4), readShardVertices<long long>(output).size());
+		}
+
+#ifdef CONVEXHULL3D_SHARD_WORKER
+		TEST_METHOD(ShardedHullWithWorkerProcesses) {
+			// Whole coordinates, so that the hulls of doubles are exact
+			std::mt19937_64 randomEngine;
+			std::uniform_int_distribution<int> coordinateGen(-10000, 10000);
+			std::vector<point<double>> points(5000);
+			for (auto& thePoint : points) {
+				thePoint = { double(coordinateGen(randomEngine)), double(coordinateGen(randomEngine)), double(coordinateGen(randomEngine)) };
+			}
+
+			std::string path = writePointFile(points);
+			process_shard_launcher launcher("\"" + std::string(CONVEXHULL3D_SHARD_WORKER) + "\"");
+			auto shardedHull = computeConvexHull3DSharded<double>(path, 4, launcher);
+			auto expectedHull = computeConvexHull3D(points);
+
+			std::set<point<double>> shardedVertices, expectedVertices;
+			for (const auto& theEdge : exploreGraph(shardedHull)) {
+				shardedVertices.insert(theEdge->origin()->data());
+			}
+			for (const auto& theEdge : exploreGraph(expectedHull)) {
+				expectedVertices.insert(theEdge->origin()->data());
+			}
+			Assert::IsTrue(expectedVertices == shardedVertices);
+			Assert::AreEqual(exploreGraph(expectedHull).size(), exploreGraph(shardedHull).size());
+			destroyGraph(shardedHull);
+			destroyGraph(expectedHull);
+
+			// A worker given points past the end of the file fails without sending a hull
+			Assert::ExpectException<std::runtime_error>([&]() { readShardVertices<double>(*launcher(shard_range{ path, 4000, 2000 })); });
+			std::filesystem::remove(path);
+		}
+#endif
+	};
+
+	TEST_CLASS(ResultCacheTests) {
+	public:
+
+		static std::vector<point<long long>> randomPoints(size_t count, unsigned seed) {
+			std::mt19937_64 randomEngine(seed);
+			std::uniform_int_distribution<long long> coordinateGen(-1000, 1000);
+			std::vector<point<long long>> points(count);
+			for (auto& thePoint : points) {
+				thePoint = { coordinateGen(randomEngine), coordinateGen(randomEngine), coordinateGen(randomEngine) };
+			}
+			return points;
+		}
+
+		// A directory in the temporary directory which no other test run uses at the same time
+		static std::filesystem::path uniqueTempDirectory() {
+			static std::atomic<unsigned> directoryCount{ 0 };
+			std::string name = "ConvexHull3DResultCacheTests-" + std::to_string(std::random_device()()) + "-" + std::to_string(directoryCount++);
+			return std::filesystem::temp_directory_path() / name;
+		}
+
+		static std::vector<std::filesystem::path> resultFiles(const std::filesystem::path& directory) {
+			std::vector<std::filesystem::path> files;
+			for (const auto& file : std::filesystem::directory_iterator(directory)) {
+				files.push_back(file.path());
+			}
+			return files;
+		}
+
+		TEST_METHOD(MemoryHitsAndKeys) {
+			hull_result_cache cache(1 << 20);
+			std::vector<point<long long>> points = randomPoints(1000, 1);
+
+			auto result = cache.computeConvexHull3DIndices(points);
+			Assert::IsTrue(result->vertices == computeConvexHull3DIndices(points).vertices);
+			Assert::IsTrue(result == cache.computeConvexHull3DIndices(points));
+
+			// The key doesn't depend on the threads hashing the points
+			convex_hull_options options;
+			options.execution = parallelExecution(4);
+			Assert::IsTrue(result == cache.computeConvexHull3DIndices(points, options));
+			Assert::AreEqual(size_t(2), cache.statistics().memoryHits);
+			Assert::AreEqual(size_t(1), cache.statistics().misses);
+
+			// Other options, another point, another order and the Delaunay triangulation are all misses
+			options.triangulate = true;
+			Assert::IsTrue(result != cache.computeConvexHull3DIndices(points, options));
+			std::vector<point<long long>> movedPoints = points;
+			movedPoints[100].x++;
+			Assert::IsTrue(result != cache.computeConvexHull3DIndices(movedPoints));
+			std::vector<point<long long>> swappedPoints = points;
+			std::swap(swappedPoints[0], swappedPoints[1]);
+			Assert::IsTrue(result != cache.computeConvexHull3DIndices(swappedPoints));
+			cache.delaunayTriangulationIndices(points);
+			Assert::AreEqual(size_t(5), cache.statistics().misses);
+
+			// A result computed with a deadline could be partial
+			std::vector<point<long long>> otherPoints = randomPoints(100, 2);
+			options = convex_hull_options();
+			options.deadline = std::chrono::steady_clock::now() + std::chrono::hours(1);
+			cache.computeConvexHull3DIndices(otherPoints, options);
+			cache.computeConvexHull3DIndices(otherPoints);
+			Assert::AreEqual(size_t(7), cache.statistics().misses);
+		}
+
+		TEST_METHOD(LeastRecentlyUsedEviction) {
+			std::vector<point<long long>> pointsA = randomPoints(1000, 1), pointsB = randomPoints(1000, 2), pointsC = randomPoints(1000, 3);
+
+			// Room for about two of the results
+			hull_result_cache sizingCache(1 << 20);
+			sizingCache.computeConvexHull3DIndices(pointsA);
+			hull_result_cache cache(sizingCache.memoryUsage() * 5 / 2);
+
+			cache.computeConvexHull3DIndices(pointsA);
+			cache.computeConvexHull3DIndices(pointsB);
+			cache.computeConvexHull3DIndices(pointsA);
+			cache.computeConvexHull3DIndices(pointsC);
+			Assert::AreEqual(size_t(3), cache.statistics().misses);
+			Assert::IsTrue(cache.memoryUsage() <= sizingCache.memoryUsage() * 5 / 2);
+
+			// B was used the least recently, so it was evicted and A wasn't
+			cache.computeConvexHull3DIndices(pointsA);
+			Assert::AreEqual(size_t(3), cache.statistics().misses);
+			cache.computeConvexHull3DIndices(pointsB);
+			Assert::AreEqual(size_t(4), cache.statistics().misses);
+		}
+
+		TEST_METHOD(DiskTier) {
+			std::filesystem::path directory = uniqueTempDirectory();
+			std::vector<point<long long>> points = randomPoints(2000, 1);
+			std::vector<point<long long>> planarPoints;
+			for (const auto& thePoint : points) {
+				planarPoints.push_back({ thePoint.x, thePoint.y, 0 });
+			}
+
+			std::shared_ptr<const convex_hull_indices> hull;
+			std::shared_ptr<const delaunay_indices> triangulation;
+			{
+				hull_result_cache cache(1 << 20, directory);
+				hull = cache.computeConvexHull3DIndices(points);
+				triangulation = cache.delaunayTriangulationIndices(planarPoints);
+			}
+
+			// A new cache finds both results on disk, and then keeps them in memory
+			hull_result_cache cache(1 << 20, directory);
+			auto loadedHull = cache.computeConvexHull3DIndices(points);
+			auto loadedTriangulation = cache.delaunayTriangulationIndices(planarPoints);
+			Assert::IsTrue(hull->vertices == loadedHull->vertices && hull->faces == loadedHull->faces);
+			Assert::IsTrue(triangulation->boundary == loadedTriangulation->boundary && triangulation->cells == loadedTriangulation->cells);
+			Assert::IsTrue(loadedHull == cache.computeConvexHull3DIndices(points));
+			Assert::AreEqual(size_t(2), cache.statistics().diskHits);
+			Assert::AreEqual(size_t(1), cache.statistics().memoryHits);
+			Assert::AreEqual(size_t(0), cache.statistics().misses);
+
+			// A truncated file is a miss, and is written again
+			for (const auto& file : std::filesystem::directory_iterator(directory)) {
+				if (file.path().extension() == ".hull") {
+					std::filesystem::resize_file(file.path(), std::filesystem::file_size(file.path()) - 1);
+				}
+			}
+
+			hull_result_cache truncatedCache(1 << 20, directory);
+			Assert::IsTrue(hull->vertices == truncatedCache.computeConvexHull3DIndices(points)->vertices);
+			Assert::AreEqual(size_t(1), truncatedCache.statistics().misses);
+			hull_result_cache rewrittenCache(1 << 20, directory);
+			rewrittenCache.computeConvexHull3DIndices(points);
+			Assert::AreEqual(size_t(1), rewrittenCache.statistics().diskHits);
+			std::filesystem::remove_all(directory);
+		}
+
+		TEST_METHOD(StaleAndCorruptFiles) {
+			std::filesystem::path directory = uniqueTempDirectory();
+			std::vector<point<long long>> points = randomPoints(2000, 1), fewPoints = randomPoints(20, 2);
+			std::filesystem::path pointsFile, fewPointsFile;
+			{
+				hull_result_cache cache(1 << 20, directory);
+				cache.computeConvexHull3DIndices(points);
+				pointsFile = resultFiles(directory).at(0);
+				cache.computeConvexHull3DIndices(fewPoints);
+				for (const auto& file : resultFiles(directory)) {
+					if (file != pointsFile) {
+						fewPointsFile = file;
+					}
+				}
+			}
+
+			// A complete file of another key, with indices out of range for the points, is a miss
+			std::filesystem::copy_file(pointsFile, fewPointsFile, std::filesystem::copy_options::overwrite_existing);
+			{
+				hull_result_cache cache(1 << 20, directory);
+				Assert::IsTrue(cache.computeConvexHull3DIndices(fewPoints)->vertices == computeConvexHull3DIndices(fewPoints).vertices);
+				Assert::AreEqual(size_t(1), cache.statistics().misses);
+			}
+
+			// So is a file of the right key with an index past the last point
+			{
+				std::fstream file(pointsFile, std::ios::binary | std::ios::in | std::ios::out);
+				file.seekp(-4, std::ios::end);
+				std::uint32_t index = std::uint32_t(points.size());
+				file.write(reinterpret_cast<const char*>(&index), sizeof(index));
+			}
+			{
+				hull_result_cache cache(1 << 20, directory);
+				Assert::IsTrue(cache.computeConvexHull3DIndices(points)->vertices == computeConvexHull3DIndices(points).vertices);
+				Assert::AreEqual(size_t(1), cache.statistics().misses);
+			}
+
+			std::filesystem::remove_all(directory);
+		}
+
+		TEST_METHOD(DiskLimit) {
+			std::filesystem::path directory = uniqueTempDirectory();
+
+			// Translated copies of the same points, whose files all have the same size
+			std::vector<std::vector<point<long long>>> pointSets(8, randomPoints(1000, 1));
+			for (size_t i = 0; i < pointSets.size(); i++) {
+				for (auto& thePoint : pointSets[i]) {
+					thePoint.x += (long long)i;
+				}
+			}
+
+			std::uintmax_t fileSize;
+			{
+				hull_result_cache cache(1 << 20, directory);
+				cache.computeConvexHull3DIndices(pointSets[0]);
+				fileSize = std::filesystem::file_size(resultFiles(directory).at(0));
+			}
+
+			// Room for five and a half files, so writing the sixth one trims the directory to three
+			// quarters of that, removing the two oldest. Nothing is kept in memory.
+			hull_result_cache cache(0, directory, fileSize * 11 / 2);
+			for (size_t i = 1; i < 6; i++) {
+				cache.computeConvexHull3DIndices(pointSets[i]);
+			}
+			Assert::AreEqual(size_t(4), resultFiles(directory).size());
+
+			// Reading a file makes it the most recently used, so the next trim keeps it
+			cache.computeConvexHull3DIndices(pointSets[2]);
+			Assert::AreEqual(size_t(1), cache.statistics().diskHits);
+			cache.computeConvexHull3DIndices(pointSets[6]);
+			cache.computeConvexHull3DIndices(pointSets[7]);
+			Assert::AreEqual(size_t(4), resultFiles(directory).size());
+			Assert::AreEqual(size_t(7), cache.statistics().misses);
+			cache.computeConvexHull3DIndices(pointSets[2]);
+			Assert::AreEqual(size_t(2), cache.statistics().diskHits);
+			cache.computeConvexHull3DIndices(pointSets[3]);
+			Assert::AreEqual(size_t(8), cache.statistics().misses);
+
+			// A new cache trims a directory which is already over its limit
+			hull_result_cache smallerCache(0, directory, fileSize / 2);
+			Assert::AreEqual(size_t(0), resultFiles(directory).size());
+			std::filesystem::remove_all(directory);
+		}
+	};
+
+	TEST_CLASS(HullDeltaTests) {
+	public:
+
+		// Keeps a copy of the hull from the deltas alone, and checks it against the whole graph
+		// after every step
+		template<class Point>
+		static bool mirrorMatchesHull(const std::vector<Point>& pts, const convex_hull_options& options) {
+			std::unordered_set<std::shared_ptr<vertex<Point>>> mirrorVertices;
+			std::unordered_set<std::shared_ptr<face<Point>>> mirrorFaces;
+			std::unordered_set<std::shared_ptr<edge<Point>>> mirrorEdges;
+			bool matches = true;
+
+			computeConvexHull3D(pts, options, [&](convex_hull_update update, const std::shared_ptr<vertex<Point>>& peakVertex, const convex_hull_delta<Point>& delta) {
+				if (update == convex_hull_update::initialTetrahedron) {
+					mirrorVertices.clear();
+					mirrorFaces.clear();
+					mirrorEdges.clear();
+				}
+
+				for (const auto& removedVertex : delta.removedVertices) {
+					matches &= mirrorVertices.erase(removedVertex) == 1;
+				}
+				for (const auto& removedFace : delta.removedFaces) {
+					matches &= mirrorFaces.erase(removedFace) == 1;
+				}
+				for (const auto& removedEdge : delta.removedEdges) {
+					matches &= mirrorEdges.erase(removedEdge) == 1;
+				}
+				for (const auto& createdVertex : delta.createdVertices) {
+					matches &= mirrorVertices.insert(createdVertex).second;
+				}
+				for (const auto& createdFace : delta.createdFaces) {
+					matches &= mirrorFaces.insert(createdFace).second;
+				}
+				for (const auto& createdEdge : delta.createdEdges) {
+					matches &= mirrorEdges.insert(createdEdge).second;
+				}
+
+				// In the middle of a step, the peak vertex may already be removed
+				if (update != convex_hull_update::initialTetrahedron && update != convex_hull_update::afterRemoveRedundantVertices) {
+					return;
+				}
+
+				std::unordered_set<std::shared_ptr<vertex<Point>>> hullVertices;
+				std::unordered_set<std::shared_ptr<face<Point>>> hullFaces;
+				std::unordered_set<std::shared_ptr<edge<Point>>> hullEdges;
+				for (const auto& theEdge : exploreGraph(peakVertex)) {
+					hullVertices.insert(theEdge->origin());
+					hullEdges.insert(theEdge);
+					hullFaces.insert(theEdge->incidentFace());
+				}
+
+				matches &= hullVertices == mirrorVertices && hullFaces == mirrorFaces && hullEdges == mirrorEdges;
+			});
+
+			return matches;
+		}
+
+		TEST_METHOD(HullDeltaMirrorsCubeLattice) {
+			std::vector<point<int>> pts;
+			for (int i = 0; i < 6; i++) {
+				for (int j = 0; j < 6; j++) {
+					for (int k = 0; k < 6; k++) {
+						pts.push_back({ i, j, k });
+					}
+				}
+			}
+
+			convex_hull_options triangulated;
+			triangulated.triangulate = true;
+			Assert::IsTrue(mirrorMatchesHull(pts, convex_hull_options()));
+			Assert::IsTrue(mirrorMatchesHull(pts, triangulated));
+		}
+
+		TEST_METHOD(HullDeltaMirrorsNoisyPlane) {
+			std::mt19937_64 randomEngine;
+			std::uniform_real_distribution<double> noiseGen(-1e-9, 1e-9);
+			std::vector<point<double>> pts;
+
+			for (int i = 0; i < 15; i++) {
+				for (int j = 0; j < 15; j++) {
+					pts.push_back({ i + noiseGen(randomEngine), j + noiseGen(randomEngine), noiseGen(randomEngine) });
+				}
+			}
+			pts.push_back({ 7, 7, 5 });
+
+			convex_hull_options options;
+			options.coplanarityTolerance = 1e-6;
+			Assert::IsTrue(mirrorMatchesHull(pts, convex_hull_options()));
+			Assert::IsTrue(mirrorMatchesHull(pts, options));
+		}
+	};
+
+	TEST_CLASS(DelaunayTriangulationTests) {
+	public:
+
+		TEST_METHOD(IsFaceDirectedUpTest1) {
+			std::vector<point<int>> pts = { {0, 0, 0}, {10, 0, 0}, {10, 0, 10} };
+			auto triangle = makePolygon(pts);
+			Assert::IsTrue(isFaceDirectedUpOrVertical(triangle));
+		}
+
+		TEST_METHOD(IsFaceDirectedUpTest2) {
+			std::vector<point<int>> pts = { {0, 0, 0}, {10, 0, 0}, {10, 1, 10} };
+			auto triangle = makePolygon(pts);
+			Assert::IsTrue(isFaceDirectedUpOrVertical(triangle));
+		}
+
+		TEST_METHOD(IsFaceDirectedUpTest3) {
+			std::vector<point<int>> pts = { {0, 0, 0}, {10, 0, 0}, {10, -1, 10} };
+			auto triangle = makePolygon(pts);
+			Assert::IsFalse(isFaceDirectedUpOrVertical(triangle));
+		}
+
+		TEST_METHOD(DelaunayTriangulationBasicTest1) {
+			std::vector<point<int>> pts = { {0, 0}, {0, 10}, {10, 0}, {6, 6} };
+			auto extFace = delaunayTriangulation(pts);
+			Assert::AreEqual(4, (int)faceToEdgeList(extFace).size());
+
+			std::pair<size_t, size_t> expectedEdges[] = { {0, 1}, {0, 2}, {0, 3}, {1, 3}, {2, 3} };
+			std::set<std::pair<size_t, size_t>> actualEdges;
+
+			for (const auto& theEdge : exploreGraph(extFace->outerComponent()->origin())) {
+				size_t u = theEdge->origin()->data().label;
+				size_t v = theEdge->destination()->data().label;
+			
+				if (u < v) {
+					actualEdges.insert({ u, v });
+				}
+			}
+
+			Assert::IsTrue(actualEdges == std::set<std::pair<size_t, size_t>>(std::begin(expectedEdges), std::end(expectedEdges)));
+		}
+
+		TEST_METHOD(DelaunayTriangulationIndicesTest) {
+			std::vector<point<int>> pts = { {0, 0}, {0, 10}, {10, 0}, {6, 6} };
+			delaunay_indices triangulation = delaunayTriangulationIndices(pts);
+			Assert::AreEqual(size_t(4), triangulation.boundary.size());
+
+			std::set<std::vector<size_t>> cells;
+			for (std::vector<size_t> cell : triangulation.cells) {
+				std::sort(cell.begin(), cell.end());
+				cells.insert(cell);
+			}
+			Assert::IsTrue(cells == std::set<std::vector<size_t>>{ { 0, 1, 3 }, { 0, 2, 3 } });
+
+			Assert::AreEqual(size_t(0), delaunayTriangulationIndices(std::vector<point<int>>{ {0, 0} }).cells.size());
 		}
 
 		TEST_METHOD(DelaunayTriangulationBasicTest2) {